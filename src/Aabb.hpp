@@ -0,0 +1,39 @@
+#pragma once
+
+#include <limits>
+#include <glm/glm.hpp>
+
+struct Aabb
+{
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+    void expand(const glm::vec3& point)
+    {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    void expand(const Aabb& other)
+    {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+
+    void inflate(float margin)
+    {
+        min -= glm::vec3(margin);
+        max += glm::vec3(margin);
+    }
+
+    bool overlaps(const Aabb& other) const
+    {
+        return min.x <= other.max.x && max.x >= other.min.x
+            && min.y <= other.max.y && max.y >= other.min.y
+            && min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    bool isEmpty()       const { return min.x > max.x; }
+    glm::vec3 center()   const { return 0.5f * (min + max); }
+    glm::vec3 extent()   const { return max - min; }
+};
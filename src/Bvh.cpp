@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <numeric>
+
+#include "Bvh.hpp"
+
+void Bvh::build(const std::vector<Aabb>& primitiveBounds)
+{
+    m_nodes.clear();
+    m_primitiveIndices.resize(primitiveBounds.size());
+    std::iota(m_primitiveIndices.begin(), m_primitiveIndices.end(), 0u);
+    if (primitiveBounds.empty()) return;
+
+    std::vector<glm::vec3> centroids(primitiveBounds.size());
+    for (size_t i = 0; i < primitiveBounds.size(); ++i)
+    {
+        centroids[i] = primitiveBounds[i].center();
+    }
+
+    m_nodes.reserve(2 * (primitiveBounds.size() / MAX_LEAF_SIZE + 1));
+    buildNode(primitiveBounds, centroids, 0, static_cast<unsigned int>(primitiveBounds.size()));
+}
+
+void Bvh::refit(const std::vector<Aabb>& primitiveBounds)
+{
+    // Children always follow their parent, so a reverse pass visits them first
+    for (size_t i = m_nodes.size(); i-- > 0;)
+    {
+        Node& node = m_nodes[i];
+        Aabb bounds;
+        if (node.count > 0)
+        {
+            for (unsigned int j = 0; j < node.count; ++j)
+            {
+                bounds.expand(primitiveBounds[m_primitiveIndices[node.first + j]]);
+            }
+        }
+        else
+        {
+            bounds = m_nodes[i + 1].bounds;
+            bounds.expand(m_nodes[node.first].bounds);
+        }
+        node.bounds = bounds;
+    }
+}
+
+unsigned int Bvh::buildNode(
+    const std::vector<Aabb>& primitiveBounds,
+    const std::vector<glm::vec3>& centroids,
+    unsigned int begin,
+    unsigned int end
+)
+{
+    unsigned int nodeIndex = static_cast<unsigned int>(m_nodes.size());
+    m_nodes.push_back(Node{});
+
+    Aabb bounds, centroidBounds;
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        bounds.expand(primitiveBounds[m_primitiveIndices[i]]);
+        centroidBounds.expand(centroids[m_primitiveIndices[i]]);
+    }
+    m_nodes[nodeIndex].bounds = bounds;
+
+    glm::vec3 extent = centroidBounds.extent();
+    int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+    if (end - begin <= MAX_LEAF_SIZE || extent[axis] <= 0.0f)
+    {
+        m_nodes[nodeIndex].first = begin;
+        m_nodes[nodeIndex].count = end - begin;
+        return nodeIndex;
+    }
+
+    // Median split along the widest centroid axis keeps the tree balanced
+    unsigned int mid = begin + (end - begin) / 2;
+    std::nth_element(
+        m_primitiveIndices.begin() + begin,
+        m_primitiveIndices.begin() + mid,
+        m_primitiveIndices.begin() + end,
+        [&centroids, axis](unsigned int a, unsigned int b) { return centroids[a][axis] < centroids[b][axis]; }
+    );
+
+    buildNode(primitiveBounds, centroids, begin, mid);
+    unsigned int right = buildNode(primitiveBounds, centroids, mid, end);
+    m_nodes[nodeIndex].first = right;
+    m_nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+
+#include "Aabb.hpp"
+#include "RayPacket.hpp"
+
+// Bounding volume hierarchy over an indexed set of primitive boxes. Nodes are stored depth
+// first, so a node's left child directly follows it and only the right child is linked.
+class Bvh
+{
+public:
+    static constexpr unsigned int MAX_LEAF_SIZE = 4;
+
+    void build(const std::vector<Aabb>& primitiveBounds);
+
+    // Recomputes node bounds for moved primitives, keeping the tree built for the old ones
+    void refit(const std::vector<Aabb>& primitiveBounds);
+
+    bool empty()  const { return m_nodes.empty(); }
+    size_t size() const { return m_primitiveIndices.size(); }
+
+    // Calls func(primitiveIndex) for every primitive whose box overlaps the query box
+    template<typename Func>
+    void query(const Aabb& box, Func&& func) const
+    {
+        if (m_nodes.empty()) return;
+
+        unsigned int stack[64];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const Node& node = m_nodes[stack[--stackSize]];
+            if (!node.bounds.overlaps(box)) continue;
+
+            if (node.count > 0)
+            {
+                for (unsigned int i = 0; i < node.count; ++i)
+                {
+                    func(m_primitiveIndices[node.first + i]);
+                }
+            }
+            else
+            {
+                unsigned int self = static_cast<unsigned int>(&node - m_nodes.data());
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = self + 1;
+            }
+        }
+    }
+
+    // Visits nodes any lane of the ray packet still reaches, nearer nodes first. func(primitiveIndex)
+    // intersects the packet, shrinking the lanes' maxT as they hit.
+    template<typename Func>
+    void queryRayPacket(const RayPacket& packet, Func&& func) const
+    {
+        if (m_nodes.empty()) return;
+
+        unsigned int stack[64];
+        int stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            unsigned int index = stack[--stackSize];
+            const Node& node = m_nodes[index];
+            float tEnter;
+            if (!packet.intersects(node.bounds, tEnter)) continue;
+
+            if (node.count > 0)
+            {
+                for (unsigned int i = 0; i < node.count; ++i)
+                {
+                    func(m_primitiveIndices[node.first + i]);
+                }
+            }
+            else
+            {
+                unsigned int left = index + 1, right = node.first;
+                float tLeft, tRight;
+                bool hitLeft = packet.intersects(m_nodes[left].bounds, tLeft);
+                bool hitRight = packet.intersects(m_nodes[right].bounds, tRight);
+                if (hitLeft && hitRight)
+                {
+                    stack[stackSize++] = tLeft < tRight ? right : left;
+                    stack[stackSize++] = tLeft < tRight ? left : right;
+                }
+                else if (hitLeft)
+                {
+                    stack[stackSize++] = left;
+                }
+                else if (hitRight)
+                {
+                    stack[stackSize++] = right;
+                }
+            }
+        }
+    }
+
+    // Calls func(bounds, isLeaf) for every node, for drawing the tree
+    template<typename Func>
+    void forEachNode(Func&& func) const
+    {
+        for (const Node& node : m_nodes)
+        {
+            func(node.bounds, node.count > 0);
+        }
+    }
+
+private:
+    struct Node
+    {
+        Aabb bounds;
+        unsigned int first; // leaf: first primitive slot, inner: right child
+        unsigned int count; // 0 for inner nodes
+    };
+
+    unsigned int buildNode(
+        const std::vector<Aabb>& primitiveBounds,
+        const std::vector<glm::vec3>& centroids,
+        unsigned int begin,
+        unsigned int end
+    );
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<unsigned int> m_primitiveIndices;
+};
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Ccd.hpp"
+#include "Intersection.hpp"
+
+namespace
+{
+    constexpr int BISECTION_STEPS = 32;
+
+    float determinant(const glm::vec3& u, const glm::vec3& v, const glm::vec3& w)
+    {
+        return glm::dot(u, glm::cross(v, w));
+    }
+
+    // Roots in [0, 1] of det(u0 + t du, v0 + t dv, w0 + t dw) in ascending order; returns their count
+    int coplanarityRoots(
+        const glm::vec3& u0, const glm::vec3& v0, const glm::vec3& w0,
+        const glm::vec3& du, const glm::vec3& dv, const glm::vec3& dw,
+        float roots[4]
+    )
+    {
+        const float c0 = determinant(u0, v0, w0);
+        const float c1 = determinant(du, v0, w0) + determinant(u0, dv, w0) + determinant(u0, v0, dw);
+        const float c2 = determinant(u0, dv, dw) + determinant(du, v0, dw) + determinant(du, dv, w0);
+        const float c3 = determinant(du, dv, dw);
+        auto f = [&](float t) { return ((c3 * t + c2) * t + c1) * t + c0; };
+
+        // Split [0, 1] at the critical points, so each interval is monotonic and holds at most one root
+        float bounds[4] = { 0.0f };
+        int numBounds = 1;
+        const float a = 3.0f * c3, b = 2.0f * c2, c = c1;
+        if (a != 0.0f)
+        {
+            float discriminant = b * b - 4.0f * a * c;
+            if (discriminant >= 0.0f)
+            {
+                float q = -0.5f * (b + std::copysign(std::sqrt(discriminant), b));
+                float t1 = q / a;
+                float t2 = q != 0.0f ? c / q : t1;
+                for (float t : { std::min(t1, t2), std::max(t1, t2) })
+                {
+                    if (t > 0.0f && t < 1.0f) bounds[numBounds++] = t;
+                }
+            }
+        }
+        else if (b != 0.0f)
+        {
+            float t = -c / b;
+            if (t > 0.0f && t < 1.0f) bounds[numBounds++] = t;
+        }
+        bounds[numBounds++] = 1.0f;
+
+        int numRoots = 0;
+        if (f(0.0f) == 0.0f) roots[numRoots++] = 0.0f;
+        for (int i = 0; i + 1 < numBounds; ++i)
+        {
+            float lo = bounds[i], hi = bounds[i + 1];
+            float fLo = f(lo), fHi = f(hi);
+            if (fHi == 0.0f)
+            {
+                roots[numRoots++] = hi;
+                continue;
+            }
+            if (fLo == 0.0f || (fLo < 0.0f) == (fHi < 0.0f)) continue;
+
+            for (int step = 0; step < BISECTION_STEPS; ++step)
+            {
+                float mid = 0.5f * (lo + hi);
+                float fMid = f(mid);
+                if ((fMid < 0.0f) == (fLo < 0.0f))
+                {
+                    lo = mid;
+                    fLo = fMid;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            roots[numRoots++] = hi;
+        }
+        return numRoots;
+    }
+
+    glm::vec3 lerp(const glm::vec3& start, const glm::vec3& end, float t)
+    {
+        return start + t * (end - start);
+    }
+}
+
+std::optional<float> Ccd::vertexTriangle(
+    const glm::vec3& p0, const glm::vec3& a0, const glm::vec3& b0, const glm::vec3& c0,
+    const glm::vec3& p1, const glm::vec3& a1, const glm::vec3& b1, const glm::vec3& c1
+)
+{
+    float roots[4];
+    int numRoots = coplanarityRoots(
+        b0 - a0, c0 - a0, p0 - a0,
+        (b1 - a1) - (b0 - a0), (c1 - a1) - (c0 - a0), (p1 - a1) - (p0 - a0),
+        roots
+    );
+
+    for (int i = 0; i < numRoots; ++i)
+    {
+        float t = roots[i];
+        auto weights = Intersection::barycentric(lerp(a0, a1, t), lerp(b0, b1, t), lerp(c0, c1, t), lerp(p0, p1, t));
+        if (weights && Intersection::isInside(*weights, 1e-4f)) return t;
+    }
+    return std::nullopt;
+}
+
+std::optional<Ccd::EdgeHit> Ccd::edgeEdge(
+    const glm::vec3& a0, const glm::vec3& b0, const glm::vec3& c0, const glm::vec3& d0,
+    const glm::vec3& a1, const glm::vec3& b1, const glm::vec3& c1, const glm::vec3& d1
+)
+{
+    float roots[4];
+    int numRoots = coplanarityRoots(
+        b0 - a0, c0 - a0, d0 - a0,
+        (b1 - a1) - (b0 - a0), (c1 - a1) - (c0 - a0), (d1 - a1) - (d0 - a0),
+        roots
+    );
+
+    for (int i = 0; i < numRoots; ++i)
+    {
+        float t = roots[i];
+        glm::vec3 a = lerp(a0, a1, t), b = lerp(b0, b1, t), c = lerp(c0, c1, t), d = lerp(d0, d1, t);
+
+        // Coplanar lines meet; the edges only touch if that happens within both segments
+        float s, u;
+        Intersection::closestSegmentParameters(a, b, c, d, s, u);
+        float tolerance = 1e-4f * (glm::length(b - a) + glm::length(d - c));
+        if (glm::distance(lerp(a, b, s), lerp(c, d, u)) <= tolerance) return EdgeHit{ t, s, u };
+    }
+    return std::nullopt;
+}
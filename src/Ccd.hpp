@@ -0,0 +1,29 @@
+#pragma once
+
+#include <optional>
+#include <glm/glm.hpp>
+
+// Continuous collision tests for primitives whose vertices move linearly over a step, from
+// positions ...0 at t = 0 to ...1 at t = 1. Contact times are the roots of the cubic that says
+// when the four points become coplanar, checked in order for an actual touch.
+namespace Ccd
+{
+    struct EdgeHit
+    {
+        float t; // time of impact in [0, 1]
+        float s; // parameter along the first edge
+        float u; // parameter along the second edge
+    };
+
+    // Earliest time point p passes through triangle (a, b, c)
+    std::optional<float> vertexTriangle(
+        const glm::vec3& p0, const glm::vec3& a0, const glm::vec3& b0, const glm::vec3& c0,
+        const glm::vec3& p1, const glm::vec3& a1, const glm::vec3& b1, const glm::vec3& c1
+    );
+
+    // Earliest time edge (a, b) passes through edge (c, d)
+    std::optional<EdgeHit> edgeEdge(
+        const glm::vec3& a0, const glm::vec3& b0, const glm::vec3& c0, const glm::vec3& d0,
+        const glm::vec3& a1, const glm::vec3& b1, const glm::vec3& c1, const glm::vec3& d1
+    );
+}
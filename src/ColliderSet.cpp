@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ColliderSet.hpp"
+
+namespace
+{
+    // Particles are copied into a block of separate x, y and z arrays, which every collider loop then streams over
+    constexpr size_t BLOCK_SIZE = 64;
+
+    // Keeps the inner loops free of branches: a particle exactly on a sphere's center or capsule's axis stays put
+    constexpr float MIN_DISTANCE_SQUARED = 1e-20f;
+
+    struct Block
+    {
+        alignas(32) float x[BLOCK_SIZE];
+        alignas(32) float y[BLOCK_SIZE];
+        alignas(32) float z[BLOCK_SIZE];
+    };
+}
+
+void ColliderSet::addPlane(const glm::vec3& normal, float offset)
+{
+    glm::vec3 n = glm::normalize(normal);
+    m_planes.nx.push_back(n.x);
+    m_planes.ny.push_back(n.y);
+    m_planes.nz.push_back(n.z);
+    m_planes.offset.push_back(offset);
+}
+
+void ColliderSet::addSphere(const glm::vec3& center, float radius)
+{
+    m_spheres.cx.push_back(center.x);
+    m_spheres.cy.push_back(center.y);
+    m_spheres.cz.push_back(center.z);
+    m_spheres.radius.push_back(radius);
+}
+
+void ColliderSet::addBox(const glm::vec3& center, const glm::vec3& halfExtents)
+{
+    m_boxes.cx.push_back(center.x);
+    m_boxes.cy.push_back(center.y);
+    m_boxes.cz.push_back(center.z);
+    m_boxes.hx.push_back(halfExtents.x);
+    m_boxes.hy.push_back(halfExtents.y);
+    m_boxes.hz.push_back(halfExtents.z);
+}
+
+void ColliderSet::addCapsule(const glm::vec3& start, const glm::vec3& end, float radius)
+{
+    m_capsules.ax.push_back(start.x);
+    m_capsules.ay.push_back(start.y);
+    m_capsules.az.push_back(start.z);
+    m_capsules.bx.push_back(end.x);
+    m_capsules.by.push_back(end.y);
+    m_capsules.bz.push_back(end.z);
+    m_capsules.radius.push_back(radius);
+}
+
+void ColliderSet::clear()
+{
+    m_planes = {};
+    m_spheres = {};
+    m_boxes = {};
+    m_capsules = {};
+}
+
+size_t ColliderSet::size() const
+{
+    return m_planes.nx.size() + m_spheres.cx.size() + m_boxes.cx.size() + m_capsules.ax.size();
+}
+
+void ColliderSet::solve(std::vector<glm::vec3>& x) const
+{
+    if (x.empty() || empty()) return;
+
+    Aabb bounds;
+    for (const auto& position : x)
+    {
+        bounds.expand(position);
+    }
+
+    // Cull colliders the object can't reach this substep
+    std::vector<unsigned int> planes, spheres, boxes, capsules;
+    for (unsigned int c = 0; c < m_planes.nx.size(); ++c)
+    {
+        glm::vec3 n(m_planes.nx[c], m_planes.ny[c], m_planes.nz[c]);
+        glm::vec3 lowest = glm::mix(bounds.max, bounds.min, glm::vec3(glm::greaterThan(n, glm::vec3(0.0f))));
+        if (glm::dot(n, lowest) < m_planes.offset[c]) planes.push_back(c);
+    }
+    for (unsigned int c = 0; c < m_spheres.cx.size(); ++c)
+    {
+        glm::vec3 center(m_spheres.cx[c], m_spheres.cy[c], m_spheres.cz[c]);
+        glm::vec3 closest = glm::clamp(center, bounds.min, bounds.max);
+        float r = m_spheres.radius[c];
+        if (glm::dot(closest - center, closest - center) < r * r) spheres.push_back(c);
+    }
+    for (unsigned int c = 0; c < m_boxes.cx.size(); ++c)
+    {
+        Aabb box;
+        box.expand(glm::vec3(m_boxes.cx[c] - m_boxes.hx[c], m_boxes.cy[c] - m_boxes.hy[c], m_boxes.cz[c] - m_boxes.hz[c]));
+        box.expand(glm::vec3(m_boxes.cx[c] + m_boxes.hx[c], m_boxes.cy[c] + m_boxes.hy[c], m_boxes.cz[c] + m_boxes.hz[c]));
+        if (box.overlaps(bounds)) boxes.push_back(c);
+    }
+    for (unsigned int c = 0; c < m_capsules.ax.size(); ++c)
+    {
+        Aabb box;
+        box.expand(glm::vec3(m_capsules.ax[c], m_capsules.ay[c], m_capsules.az[c]));
+        box.expand(glm::vec3(m_capsules.bx[c], m_capsules.by[c], m_capsules.bz[c]));
+        box.inflate(m_capsules.radius[c]);
+        if (box.overlaps(bounds)) capsules.push_back(c);
+    }
+    if (planes.empty() && spheres.empty() && boxes.empty() && capsules.empty()) return;
+
+    Block block;
+    for (size_t begin = 0; begin < x.size(); begin += BLOCK_SIZE)
+    {
+        const size_t count = std::min(BLOCK_SIZE, x.size() - begin);
+        for (size_t i = 0; i < count; ++i)
+        {
+            block.x[i] = x[begin + i].x;
+            block.y[i] = x[begin + i].y;
+            block.z[i] = x[begin + i].z;
+        }
+
+        for (unsigned int c : planes)
+        {
+            const float nx = m_planes.nx[c], ny = m_planes.ny[c], nz = m_planes.nz[c], offset = m_planes.offset[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                float depth = std::min(nx * block.x[i] + ny * block.y[i] + nz * block.z[i] - offset, 0.0f);
+                block.x[i] -= depth * nx;
+                block.y[i] -= depth * ny;
+                block.z[i] -= depth * nz;
+            }
+        }
+
+        for (unsigned int c : spheres)
+        {
+            const float cx = m_spheres.cx[c], cy = m_spheres.cy[c], cz = m_spheres.cz[c], r = m_spheres.radius[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                float dx = block.x[i] - cx, dy = block.y[i] - cy, dz = block.z[i] - cz;
+                float distance = std::sqrt(std::max(dx * dx + dy * dy + dz * dz, MIN_DISTANCE_SQUARED));
+                float scale = std::max(r - distance, 0.0f) / distance;
+                block.x[i] += scale * dx;
+                block.y[i] += scale * dy;
+                block.z[i] += scale * dz;
+            }
+        }
+
+        for (unsigned int c : capsules)
+        {
+            const float ax = m_capsules.ax[c], ay = m_capsules.ay[c], az = m_capsules.az[c];
+            const float abx = m_capsules.bx[c] - ax, aby = m_capsules.by[c] - ay, abz = m_capsules.bz[c] - az;
+            const float lengthSquared = abx * abx + aby * aby + abz * abz;
+            const float inverseLengthSquared = lengthSquared > 0.0f ? 1.0f / lengthSquared : 0.0f;
+            const float r = m_capsules.radius[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Pushed away from the closest point on the axis, like a sphere sliding along it
+                float t = ((block.x[i] - ax) * abx + (block.y[i] - ay) * aby + (block.z[i] - az) * abz) * inverseLengthSquared;
+                t = std::clamp(t, 0.0f, 1.0f);
+                float dx = block.x[i] - (ax + t * abx), dy = block.y[i] - (ay + t * aby), dz = block.z[i] - (az + t * abz);
+                float distance = std::sqrt(std::max(dx * dx + dy * dy + dz * dz, MIN_DISTANCE_SQUARED));
+                float scale = std::max(r - distance, 0.0f) / distance;
+                block.x[i] += scale * dx;
+                block.y[i] += scale * dy;
+                block.z[i] += scale * dz;
+            }
+        }
+
+        for (unsigned int c : boxes)
+        {
+            const float cx = m_boxes.cx[c], cy = m_boxes.cy[c], cz = m_boxes.cz[c];
+            const float hx = m_boxes.hx[c], hy = m_boxes.hy[c], hz = m_boxes.hz[c];
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Out through the face of least penetration
+                float lx = block.x[i] - cx, ly = block.y[i] - cy, lz = block.z[i] - cz;
+                float px = hx - std::abs(lx), py = hy - std::abs(ly), pz = hz - std::abs(lz);
+                bool inside = (px > 0.0f) & (py > 0.0f) & (pz > 0.0f);
+                bool alongX = (px <= py) & (px <= pz);
+                bool alongY = !alongX & (py <= pz);
+                bool alongZ = !alongX & !alongY;
+                block.x[i] += (inside & alongX) ? std::copysign(px, lx) : 0.0f;
+                block.y[i] += (inside & alongY) ? std::copysign(py, ly) : 0.0f;
+                block.z[i] += (inside & alongZ) ? std::copysign(pz, lz) : 0.0f;
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[begin + i] = glm::vec3(block.x[i], block.y[i], block.z[i]);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Aabb.hpp"
+
+// Analytic obstacles declared in the scene file. Each shape type is stored as a structure of
+// arrays, and particles are projected in fixed-size blocks so the inner loops vectorise.
+class ColliderSet
+{
+public:
+    // Half-space boundary: keeps particles where dot(normal, x) >= offset
+    void addPlane(const glm::vec3& normal, float offset);
+    // Solid obstacles particles are pushed out of
+    void addSphere(const glm::vec3& center, float radius);
+    void addBox(const glm::vec3& center, const glm::vec3& halfExtents);
+    void addCapsule(const glm::vec3& start, const glm::vec3& end, float radius);
+
+    void clear();
+    bool empty() const { return size() == 0; }
+    size_t size() const;
+
+    // Projects every particle out of the colliders that reach the particles' bounding box
+    void solve(std::vector<glm::vec3>& x) const;
+
+private:
+    struct Planes
+    {
+        std::vector<float> nx, ny, nz, offset;
+    };
+
+    struct Spheres
+    {
+        std::vector<float> cx, cy, cz, radius;
+    };
+
+    struct Boxes
+    {
+        std::vector<float> cx, cy, cz, hx, hy, hz;
+    };
+
+    struct Capsules
+    {
+        std::vector<float> ax, ay, az;
+        std::vector<float> bx, by, bz;
+        std::vector<float> radius;
+    };
+
+private:
+    Planes m_planes;
+    Spheres m_spheres;
+    Boxes m_boxes;
+    Capsules m_capsules;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+
+// Features in contact: a particle or edge of one body against a triangle or edge of another
+struct ContactKey
+{
+    unsigned int feature;
+    unsigned int otherFeature;
+    unsigned int otherBody = 0;
+
+    bool operator==(const ContactKey& other) const = default;
+};
+
+struct ContactKeyHash
+{
+    size_t operator()(const ContactKey& key) const
+    {
+        uint64_t h = (static_cast<uint64_t>(key.feature) << 32) | key.otherFeature;
+        h ^= static_cast<uint64_t>(key.otherBody) * 0x9E3779B97F4A7C15ull;
+        return std::hash<uint64_t>{}(h);
+    }
+};
+
+// The side every contact of the last frame was kept on. Detection reads it while the new frame's
+// contacts are recorded, so a resting contact keeps its side even after the solver left the
+// particle slightly behind the surface, where fresh detection would flip or drop it.
+class ContactCache
+{
+public:
+    std::optional<float> find(const ContactKey& key) const
+    {
+        auto it = m_sides.find(key);
+        if (it == m_sides.end()) return std::nullopt;
+        return it->second;
+    }
+
+    void record(const ContactKey& key, float side) { m_next[key] = side; }
+
+    // Recorded contacts become the ones found from now on; contacts not recorded again are dropped
+    void commit()
+    {
+        m_sides.swap(m_next);
+        m_next.clear();
+    }
+
+    void clear()
+    {
+        m_sides.clear();
+        m_next.clear();
+    }
+
+private:
+    std::unordered_map<ContactKey, float, ContactKeyHash> m_sides;
+    std::unordered_map<ContactKey, float, ContactKeyHash> m_next;
+};
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+#include "DebugDraw.hpp"
+
+namespace
+{
+    constexpr size_t MIN_CAPACITY = 4096;
+}
+
+void DebugDraw::addBox(const Aabb& box, uint32_t color)
+{
+    const glm::vec3& a = box.min;
+    const glm::vec3& b = box.max;
+    const glm::vec3 corners[8] = {
+        { a.x, a.y, a.z }, { b.x, a.y, a.z }, { b.x, b.y, a.z }, { a.x, b.y, a.z },
+        { a.x, a.y, b.z }, { b.x, a.y, b.z }, { b.x, b.y, b.z }, { a.x, b.y, b.z }
+    };
+    for (int i = 0; i < 4; ++i)
+    {
+        addLine(corners[i], corners[(i + 1) % 4], color);
+        addLine(corners[i + 4], corners[(i + 1) % 4 + 4], color);
+        addLine(corners[i], corners[i + 4], color);
+    }
+}
+
+void DebugDraw::flush(RenderState& state, const Shader& shader)
+{
+    if (empty()) return;
+
+    // Lines then points, so both go up in one write
+    const GLsizei lineCount = static_cast<GLsizei>(m_lines.size());
+    const GLsizei pointCount = static_cast<GLsizei>(m_points.size());
+    m_lines.insert(m_lines.end(), m_points.begin(), m_points.end());
+
+    if (m_lines.size() > m_capacity)
+    {
+        reserve(m_lines.size());
+        state.invalidateVertexArray();
+    }
+
+    const unsigned int segment = m_vertexStream.write(m_lines.data(), m_lines.size() * sizeof(Vertex), state);
+
+    state.useProgram(shader.getID());
+    state.setPolygonMode(GL_FILL);
+    state.setCullFace(false);
+    state.setLineWidth(1.0f);
+    state.bindVertexArray(m_VAO);
+
+    const GLint first = static_cast<GLint>(segment * m_capacity);
+    if (lineCount > 0)
+    {
+        glDrawArrays(GL_LINES, first, lineCount);
+        state.countDraw();
+    }
+    if (pointCount > 0)
+    {
+        glPointSize(POINT_SIZE);
+        glDrawArrays(GL_POINTS, first + lineCount, pointCount);
+        state.countCalls(1);
+        state.countDraw();
+    }
+    m_vertexStream.fence(segment, state);
+
+    m_lines.clear();
+    m_points.clear();
+}
+
+void DebugDraw::reserve(size_t vertexCount)
+{
+    destroy();
+    m_capacity = std::max(MIN_CAPACITY, std::bit_ceil(vertexCount));
+
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+
+    m_vertexStream.create(m_capacity * sizeof(Vertex), nullptr);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+
+    glBindVertexArray(0);
+}
+
+void DebugDraw::destroy()
+{
+    if (m_VAO)
+    {
+        glDeleteVertexArrays(1, &m_VAO);
+        m_vertexStream.destroy();
+    }
+    m_VAO = 0;
+    m_capacity = 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include "Aabb.hpp"
+#include "RenderState.hpp"
+#include "Shader.hpp"
+#include "VertexStream.hpp"
+
+// Lines and points any subsystem adds during a frame, streamed together into one vertex stream and
+// drawn with one call per primitive type. Nothing is gathered for overlays that are switched off,
+// so the cost follows what is shown.
+class DebugDraw
+{
+public:
+    // Scene-wide overlays; normals are switched per object
+    struct Options
+    {
+        bool bounds = false;
+        bool bvh = false;
+        bool contacts = false;
+        bool constraintStrain = false;
+    };
+
+    struct Vertex
+    {
+        glm::vec3 position;
+        uint32_t color; // RGBA8, normalised by the GPU
+    };
+
+    static constexpr float POINT_SIZE = 5.0f;
+
+    static uint32_t packColor(const glm::vec4& color) { return glm::packUnorm4x8(color); }
+
+    void addLine(const glm::vec3& a, const glm::vec3& b, uint32_t color)
+    {
+        m_lines.push_back({ a, color });
+        m_lines.push_back({ b, color });
+    }
+
+    void addPoint(const glm::vec3& position, uint32_t color)
+    {
+        m_points.push_back({ position, color });
+    }
+
+    // The twelve edges of the box
+    void addBox(const Aabb& box, uint32_t color);
+
+    bool empty() const { return m_lines.empty() && m_points.empty(); }
+
+    // Streams the frame's lines and points and draws them, then starts the next frame empty
+    void flush(RenderState& state, const Shader& shader);
+    void destroy();
+
+private:
+    void reserve(size_t vertexCount);
+
+private:
+    std::vector<Vertex> m_lines;
+    std::vector<Vertex> m_points;
+
+    GLuint m_VAO = 0;
+    VertexStream m_vertexStream;
+    size_t m_capacity = 0; // vertices per segment
+};
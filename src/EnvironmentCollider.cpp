@@ -0,0 +1,298 @@
+#include "Ccd.hpp"
+#include "EnvironmentCollider.hpp"
+#include "Intersection.hpp"
+#include "MeshAdjacency.hpp"
+#include "Object.hpp"
+
+void EnvironmentCollider::appendObject(Object* object, KinematicSource* source)
+{
+    Mesh& mesh = object->getMesh();
+    const auto& positions = mesh.getPositions();
+    for (const auto& edge : mesh.envCollisionConstraintEdges)
+    {
+        m_edges.push_back({ positions[edge.v1], positions[edge.v2] });
+        if (source) source->edges.push_back(edge);
+    }
+    for (const auto& tri : mesh.getAdjacency().getTriangles())
+    {
+        StaticTriangle triangle;
+        triangle.a = positions[tri.v1];
+        triangle.b = positions[tri.v2];
+        triangle.c = positions[tri.v3];
+
+        glm::vec3 n = glm::cross(triangle.b - triangle.a, triangle.c - triangle.a);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+
+        triangle.normal = n / length;
+        triangle.twoSided = !mesh.isClosed();
+        m_triangles.push_back(triangle);
+        if (source) source->triangles.push_back(tri);
+    }
+}
+
+void EnvironmentCollider::build(const std::vector<Object*>& staticObjects)
+{
+    m_triangles.clear();
+    m_edges.clear();
+    m_kinematicSources.clear();
+
+    // Static primitives first, so the kinematic ones form a single range at the end
+    for (Object* object : staticObjects)
+    {
+        if (!object->isKinematic()) appendObject(object, nullptr);
+    }
+    m_staticTriangleCount = static_cast<unsigned int>(m_triangles.size());
+    m_staticEdgeCount = static_cast<unsigned int>(m_edges.size());
+
+    for (Object* object : staticObjects)
+    {
+        if (!object->isKinematic()) continue;
+        KinematicSource source{ object, {}, {} };
+        appendObject(object, &source);
+        m_kinematicSources.push_back(std::move(source));
+    }
+    m_triangleMotion.assign(m_triangles.size() - m_staticTriangleCount, TriangleMotion{});
+    m_edgeMotion.assign(m_edges.size() - m_staticEdgeCount, EdgeMotion{});
+
+    auto triangleBounds = [this](size_t begin, size_t end) {
+        std::vector<Aabb> bounds(end - begin);
+        for (size_t i = begin; i < end; ++i)
+        {
+            bounds[i - begin].expand(m_triangles[i].a);
+            bounds[i - begin].expand(m_triangles[i].b);
+            bounds[i - begin].expand(m_triangles[i].c);
+        }
+        return bounds;
+    };
+    auto edgeBounds = [this](size_t begin, size_t end) {
+        std::vector<Aabb> bounds(end - begin);
+        for (size_t i = begin; i < end; ++i)
+        {
+            bounds[i - begin].expand(m_edges[i].a);
+            bounds[i - begin].expand(m_edges[i].b);
+        }
+        return bounds;
+    };
+    m_bvh.build(triangleBounds(0, m_staticTriangleCount));
+    m_edgeBvh.build(edgeBounds(0, m_staticEdgeCount));
+    m_kinematicBvh.build(triangleBounds(m_staticTriangleCount, m_triangles.size()));
+    m_kinematicEdgeBvh.build(edgeBounds(m_staticEdgeCount, m_edges.size()));
+}
+
+void EnvironmentCollider::refitKinematic()
+{
+    moveKinematic(true);
+}
+
+void EnvironmentCollider::resetKinematic()
+{
+    moveKinematic(false);
+}
+
+void EnvironmentCollider::moveKinematic(bool trackMotion)
+{
+    if (m_kinematicSources.empty()) return;
+
+    // Boxes cover each primitive at both ends of its motion, so sweeps against it can't miss
+    m_kinematicBounds.assign(m_triangleMotion.size(), Aabb{});
+    size_t t = 0;
+    for (const auto& source : m_kinematicSources)
+    {
+        const auto& vertexTransforms = source.object->getVertexTransforms();
+        for (const auto& tri : source.triangles)
+        {
+            StaticTriangle& triangle = m_triangles[m_staticTriangleCount + t];
+            glm::vec3 a = vertexTransforms[tri.v1].getPosition();
+            glm::vec3 b = vertexTransforms[tri.v2].getPosition();
+            glm::vec3 c = vertexTransforms[tri.v3].getPosition();
+            if (!trackMotion)
+            {
+                triangle.a = a;
+                triangle.b = b;
+                triangle.c = c;
+            }
+            m_triangleMotion[t] = { a - triangle.a, b - triangle.b, c - triangle.c };
+
+            Aabb& bounds = m_kinematicBounds[t];
+            bounds.expand(triangle.a);
+            bounds.expand(triangle.b);
+            bounds.expand(triangle.c);
+            bounds.expand(a);
+            bounds.expand(b);
+            bounds.expand(c);
+
+            // Rigid motion keeps the area, so the normal never degenerates
+            triangle.a = a;
+            triangle.b = b;
+            triangle.c = c;
+            triangle.normal = glm::normalize(glm::cross(b - a, c - a));
+            ++t;
+        }
+    }
+    m_kinematicBvh.refit(m_kinematicBounds);
+
+    m_kinematicBounds.assign(m_edgeMotion.size(), Aabb{});
+    size_t e = 0;
+    for (const auto& source : m_kinematicSources)
+    {
+        const auto& vertexTransforms = source.object->getVertexTransforms();
+        for (const auto& meshEdge : source.edges)
+        {
+            StaticEdge& edge = m_edges[m_staticEdgeCount + e];
+            glm::vec3 a = vertexTransforms[meshEdge.v1].getPosition();
+            glm::vec3 b = vertexTransforms[meshEdge.v2].getPosition();
+            if (!trackMotion)
+            {
+                edge.a = a;
+                edge.b = b;
+            }
+            m_edgeMotion[e] = { a - edge.a, b - edge.b };
+
+            Aabb& bounds = m_kinematicBounds[e];
+            bounds.expand(edge.a);
+            bounds.expand(edge.b);
+            bounds.expand(a);
+            bounds.expand(b);
+
+            edge.a = a;
+            edge.b = b;
+            ++e;
+        }
+    }
+    m_kinematicEdgeBvh.refit(m_kinematicBounds);
+}
+
+void EnvironmentCollider::detectContacts(
+    const std::vector<glm::vec3>& p,
+    const std::vector<glm::vec3>& x,
+    std::span<const unsigned int> vertices,
+    float thickness,
+    float margin,
+    const ContactCache& cache,
+    std::vector<EnvContact>& contacts
+) const
+{
+    const float reach = thickness + margin;
+    for (unsigned int vertex : vertices)
+    {
+        const glm::vec3& start = p[vertex];
+        const glm::vec3& end = x[vertex];
+
+        Aabb sweep;
+        sweep.expand(start);
+        sweep.expand(end);
+        sweep.inflate(reach);
+
+        float deepest = 0.0f;
+        EnvContact contact;
+        queryTriangles(sweep, [&](unsigned int index) {
+            const StaticTriangle& triangle = m_triangles[index];
+            const TriangleMotion motion = triangleMotion(index);
+
+            // Where the particle started relative to the triangle, which has since moved to where it is now
+            glm::vec3 relativeStart = start + (motion.a + motion.b + motion.c) / 3.0f;
+            float startDistance = glm::dot(triangle.normal, relativeStart - triangle.a);
+            float endDistance = glm::dot(triangle.normal, end - triangle.a);
+
+            ContactKey key{ vertex, index };
+            std::optional<float> cached = cache.find(key);
+            float side = cached ? *cached : ((triangle.twoSided && startDistance < 0.0f) ? -1.0f : 1.0f);
+            startDistance *= side;
+            endDistance *= side;
+
+            // Ends clear of the surface, or started behind a one-sided face it wasn't already touching
+            if (endDistance >= reach || (!cached && startDistance < -thickness)) return;
+
+            // Where the sweep entered the band, so fast particles can't tunnel
+            glm::vec3 point = end;
+            if (startDistance > reach)
+            {
+                float t = (startDistance - reach) / (startDistance - endDistance);
+                point = relativeStart + t * (end - relativeStart);
+            }
+            auto weights = Intersection::barycentric(triangle.a, triangle.b, triangle.c, point);
+            if (!weights || !Intersection::isInside(*weights, 1e-4f)) return;
+
+            float depth = reach - endDistance;
+            if (depth > deepest)
+            {
+                deepest = depth;
+                glm::vec3 displacement = weights->x * motion.a + weights->y * motion.b + weights->z * motion.c;
+                contact.vertex = vertex;
+                contact.normal = side * triangle.normal;
+                contact.shift = glm::dot(contact.normal, displacement);
+                contact.offset = glm::dot(contact.normal, triangle.a) + thickness - contact.shift;
+                contact.key = key;
+                contact.side = side;
+            }
+        });
+
+        if (deepest > 0.0f)
+        {
+            contacts.push_back(contact);
+        }
+    }
+}
+
+void EnvironmentCollider::detectEdgeContacts(
+    const std::vector<glm::vec3>& p,
+    const std::vector<glm::vec3>& x,
+    std::span<const Mesh::Edge> edges,
+    float thickness,
+    float margin,
+    const ContactCache& cache,
+    std::vector<EnvEdgeContact>& contacts
+) const
+{
+    for (unsigned int e = 0; e < edges.size(); ++e)
+    {
+        const Mesh::Edge& edge = edges[e];
+        const glm::vec3 &a0 = p[edge.v1], &b0 = p[edge.v2];
+        const glm::vec3 &a1 = x[edge.v1], &b1 = x[edge.v2];
+
+        Aabb sweep;
+        sweep.expand(a0);
+        sweep.expand(b0);
+        sweep.expand(a1);
+        sweep.expand(b1);
+        sweep.inflate(thickness + margin);
+
+        std::optional<Ccd::EdgeHit> first;
+        unsigned int firstIndex = 0;
+        queryEdges(sweep, [&](unsigned int index) {
+            const StaticEdge& other = m_edges[index];
+            const EdgeMotion motion = edgeMotion(index);
+            auto hit = Ccd::edgeEdge(a0, b0, other.a - motion.a, other.b - motion.b, a1, b1, other.a, other.b);
+            if (hit && (!first || hit->t < first->t))
+            {
+                first = hit;
+                firstIndex = index;
+            }
+        });
+        if (!first) continue;
+
+        // Separating direction is perpendicular to both edges at impact, facing where the edge came from
+        const StaticEdge& firstEdge = m_edges[firstIndex];
+        const EdgeMotion motion = edgeMotion(firstIndex);
+        glm::vec3 c0 = firstEdge.a - motion.a, d0 = firstEdge.b - motion.b;
+        glm::vec3 staticStart = c0 + first->u * (d0 - c0);
+        glm::vec3 staticEnd = firstEdge.a + first->u * (firstEdge.b - firstEdge.a);
+        glm::vec3 startPoint = a0 + first->s * (b0 - a0);
+        glm::vec3 direction = (b0 - a0) + first->t * ((b1 - b0) - (a1 - a0));
+        glm::vec3 staticDirection = (d0 - c0) + first->t * ((firstEdge.b - firstEdge.a) - (d0 - c0));
+        glm::vec3 n = glm::cross(direction, staticDirection);
+        if (glm::dot(n, n) <= 1e-12f) n = startPoint - staticStart;
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n /= length;
+
+        ContactKey key{ e, firstIndex };
+        std::optional<float> cached = cache.find(key);
+        float side = cached ? *cached : (glm::dot(n, startPoint - staticStart) < 0.0f ? -1.0f : 1.0f);
+        n *= side;
+
+        float shift = glm::dot(n, staticEnd - staticStart);
+        contacts.push_back({ edge, first->s, n, glm::dot(n, staticStart) + thickness, shift, key, side });
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Bvh.hpp"
+#include "ContactCache.hpp"
+#include "Mesh.hpp"
+
+class Object;
+
+// Non-penetration contact of one particle against static geometry: dot(normal, x) >= offset at the
+// start of the frame, with the plane moving by shift along its normal over the frame
+struct EnvContact
+{
+    unsigned int vertex;
+    glm::vec3 normal;
+    float offset;
+    float shift;
+    ContactKey key; // vertex and static triangle
+    float side;
+};
+
+// Edge of a particle pair swept through a static edge: dot(normal, lerp(x[v1], x[v2], s)) >= offset,
+// moving by shift like a vertex contact
+struct EnvEdgeContact
+{
+    Mesh::Edge edge;
+    float s;
+    glm::vec3 normal;
+    float offset;
+    float shift;
+    ContactKey key; // edge and static edge
+    float side;
+};
+
+// World-space triangles and surface edges of every static object behind two BVHs, built once per
+// scene. Kinematic objects get their own pair of trees, refitted every frame to where they moved.
+class EnvironmentCollider
+{
+public:
+    void build(const std::vector<Object*>& staticObjects);
+
+    // Moves kinematic triangles and edges to their objects' current positions, remembering how far
+    // they moved since the last call so contacts can carry the surface along over the frame
+    void refitKinematic();
+    // Moves them to their objects' current positions without motion, after a kinematic object was
+    // sent back to its start so the jump isn't mistaken for a frame of surface motion
+    void resetKinematic();
+
+    bool empty()              const { return m_bvh.empty() && m_kinematicBvh.empty(); }
+    bool hasKinematic()       const { return !m_kinematicSources.empty(); }
+    size_t getTriangleCount() const { return m_triangles.size(); }
+    const Bvh& getTriangleBvh()          const { return m_bvh; }
+    const Bvh& getKinematicTriangleBvh() const { return m_kinematicBvh; }
+
+    // Sweeps each listed particle from p to x and appends a contact for the deepest triangle it
+    // ends up closer than thickness + margin to; the contact itself holds it at thickness. Closed
+    // meshes are one-sided along their outward normal, open surfaces keep particles on the side
+    // they started on, or the side the cache kept them on last frame. Kinematic triangles are
+    // swept too, by testing the particle's motion relative to theirs.
+    void detectContacts(
+        const std::vector<glm::vec3>& p,
+        const std::vector<glm::vec3>& x,
+        std::span<const unsigned int> vertices,
+        float thickness,
+        float margin,
+        const ContactCache& cache,
+        std::vector<EnvContact>& contacts
+    ) const;
+
+    // Sweeps each listed edge from p to x and appends a contact for the first static edge it
+    // passes through, found exactly by continuous collision so thin geometry can't be skipped
+    void detectEdgeContacts(
+        const std::vector<glm::vec3>& p,
+        const std::vector<glm::vec3>& x,
+        std::span<const Mesh::Edge> edges,
+        float thickness,
+        float margin,
+        const ContactCache& cache,
+        std::vector<EnvEdgeContact>& contacts
+    ) const;
+
+private:
+    struct StaticTriangle
+    {
+        glm::vec3 a, b, c;
+        glm::vec3 normal;
+        bool twoSided;
+    };
+
+    struct StaticEdge
+    {
+        glm::vec3 a, b;
+    };
+
+    // Displacement of each corner since the previous refit
+    struct TriangleMotion
+    {
+        glm::vec3 a, b, c;
+    };
+
+    struct EdgeMotion
+    {
+        glm::vec3 a, b;
+    };
+
+    // Kinematic triangles and edges follow the static ones, in source order
+    struct KinematicSource
+    {
+        Object* object;
+        std::vector<Mesh::Triangle> triangles;
+        std::vector<Mesh::Edge> edges;
+    };
+
+    // Primitive indices over both trees, kinematic ones after the static ones
+    template<typename Func>
+    void queryTriangles(const Aabb& box, Func&& func) const
+    {
+        m_bvh.query(box, func);
+        m_kinematicBvh.query(box, [&](unsigned int index) { func(m_staticTriangleCount + index); });
+    }
+
+    template<typename Func>
+    void queryEdges(const Aabb& box, Func&& func) const
+    {
+        m_edgeBvh.query(box, func);
+        m_kinematicEdgeBvh.query(box, [&](unsigned int index) { func(m_staticEdgeCount + index); });
+    }
+
+    TriangleMotion triangleMotion(unsigned int index) const
+    {
+        if (index < m_staticTriangleCount) return { glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f) };
+        return m_triangleMotion[index - m_staticTriangleCount];
+    }
+
+    EdgeMotion edgeMotion(unsigned int index) const
+    {
+        if (index < m_staticEdgeCount) return { glm::vec3(0.0f), glm::vec3(0.0f) };
+        return m_edgeMotion[index - m_staticEdgeCount];
+    }
+
+    // Appends the object's world-space primitives, recording their vertices in source if kinematic
+    void appendObject(Object* object, KinematicSource* source);
+
+    void moveKinematic(bool trackMotion);
+
+private:
+    std::vector<StaticTriangle> m_triangles;
+    Bvh m_bvh;
+    std::vector<StaticEdge> m_edges;
+    Bvh m_edgeBvh;
+    unsigned int m_staticTriangleCount = 0;
+    unsigned int m_staticEdgeCount = 0;
+
+    std::vector<KinematicSource> m_kinematicSources;
+    std::vector<TriangleMotion> m_triangleMotion;
+    std::vector<EdgeMotion> m_edgeMotion;
+    std::vector<Aabb> m_kinematicBounds;
+    Bvh m_kinematicBvh;
+    Bvh m_kinematicEdgeBvh;
+};
@@ -0,0 +1,173 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "logger.hpp"
+#include "FrameCapture.hpp"
+
+namespace
+{
+    constexpr GLuint64 WAIT_TIMEOUT_NS = 1000000;
+
+    // Binary PPM, rows flipped from GL's bottom-up order and alpha dropped
+    void writePpm(const std::string& path, unsigned int width, unsigned int height, const std::vector<uint8_t>& rgba)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+        {
+            logger::error("Failed to write frame '{}'", path);
+            return;
+        }
+
+        file << "P6\n" << width << ' ' << height << "\n255\n";
+        std::vector<uint8_t> row(width * 3);
+        for (unsigned int y = 0; y < height; ++y)
+        {
+            const uint8_t* source = rgba.data() + static_cast<size_t>(height - 1 - y) * width * 4;
+            for (unsigned int x = 0; x < width; ++x)
+            {
+                row[x * 3 + 0] = source[x * 4 + 0];
+                row[x * 3 + 1] = source[x * 4 + 1];
+                row[x * 3 + 2] = source[x * 4 + 2];
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), row.size());
+        }
+    }
+}
+
+FrameCapture::FrameCapture(unsigned int width, unsigned int height, std::string outputDirectory)
+    : m_width(width),
+      m_height(height),
+      m_outputDirectory(std::move(outputDirectory))
+{
+    glGenFramebuffers(1, &m_framebuffer);
+    glGenRenderbuffers(1, &m_colorBuffer);
+    glGenRenderbuffers(1, &m_depthBuffer);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw std::runtime_error("Offscreen framebuffer is incomplete");
+    }
+
+    if (m_outputDirectory.empty()) return;
+
+    std::filesystem::create_directories(m_outputDirectory);
+
+    const GLsizeiptr frameSize = static_cast<GLsizeiptr>(width) * height * 4;
+    glGenBuffers(PBO_COUNT, m_pixelBuffers);
+    for (GLuint pixelBuffer : m_pixelBuffers)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+FrameCapture::~FrameCapture()
+{
+    finish();
+
+    for (GLsync& fence : m_fences)
+    {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (m_pixelBuffers[0]) glDeleteBuffers(PBO_COUNT, m_pixelBuffers);
+    glDeleteRenderbuffers(1, &m_colorBuffer);
+    glDeleteRenderbuffers(1, &m_depthBuffer);
+    glDeleteFramebuffers(1, &m_framebuffer);
+}
+
+void FrameCapture::bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, m_width, m_height);
+}
+
+void FrameCapture::capture()
+{
+    const unsigned int frame = m_framesCaptured++;
+    if (m_outputDirectory.empty()) return;
+
+    // This slot's last readback was started PBO_COUNT frames ago and has had time to finish
+    const unsigned int slot = frame % PBO_COUNT;
+    if (m_fences[slot]) readBack(slot);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[slot]);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_slotFrames[slot] = frame;
+}
+
+void FrameCapture::readBack(unsigned int slot)
+{
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(m_fences[slot], flags, WAIT_TIMEOUT_NS) == GL_TIMEOUT_EXPIRED)
+    {
+        flags = 0;
+    }
+    glDeleteSync(m_fences[slot]);
+    m_fences[slot] = nullptr;
+
+    const size_t frameSize = static_cast<size_t>(m_width) * m_height * 4;
+    auto pixels = std::make_shared<std::vector<uint8_t>>(frameSize);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[slot]);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameSize, GL_MAP_READ_BIT);
+    if (mapped)
+    {
+        std::memcpy(pixels->data(), mapped, frameSize);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else
+    {
+        logger::error("Failed to map frame {} for readback", m_slotFrames[slot]);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!mapped) return;
+
+    // A writer that falls behind holds back rendering rather than buffering frames without bound
+    while (m_pendingWrites.size() >= MAX_PENDING_WRITES)
+    {
+        m_pendingWrites.front().get();
+        m_pendingWrites.pop_front();
+    }
+
+    std::ostringstream path;
+    path << m_outputDirectory << "/frame_" << std::setw(5) << std::setfill('0') << m_slotFrames[slot] << ".ppm";
+    m_pendingWrites.push_back(m_writer.enqueue([path = path.str(), width = m_width, height = m_height, pixels]() {
+        writePpm(path, width, height, *pixels);
+    }));
+}
+
+void FrameCapture::finish()
+{
+    // Oldest first, so frames reach the writer in order
+    for (unsigned int i = 0; i < PBO_COUNT; ++i)
+    {
+        const unsigned int slot = (m_framesCaptured + i) % PBO_COUNT;
+        if (m_fences[slot]) readBack(slot);
+    }
+
+    for (auto& write : m_pendingWrites)
+    {
+        write.get();
+    }
+    m_pendingWrites.clear();
+}
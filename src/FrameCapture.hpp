@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <string>
+#include <glad.h>
+
+#include "ThreadPool.hpp"
+
+// Offscreen render target for headless runs. Each captured frame is read back asynchronously into
+// one of PBO_COUNT pixel buffers and only mapped PBO_COUNT - 1 frames later, once the GPU is long
+// done with it, then written as a PPM image on a background thread. Without an output directory
+// frames are rendered but never read back, which measures rendering alone.
+class FrameCapture
+{
+public:
+    static constexpr unsigned int PBO_COUNT = 3;
+    static constexpr size_t MAX_PENDING_WRITES = 8;
+
+    FrameCapture(unsigned int width, unsigned int height, std::string outputDirectory);
+    ~FrameCapture();
+
+    // Makes the offscreen framebuffer the draw target
+    void bind();
+
+    // Starts reading back the frame just rendered and hands the oldest finished readback to the writer
+    void capture();
+
+    // Reads back the frames still in flight and waits until every image is written
+    void finish();
+
+    unsigned int getFramesCaptured() const { return m_framesCaptured; }
+
+private:
+    void readBack(unsigned int slot);
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+    std::string m_outputDirectory;
+
+    GLuint m_framebuffer = 0;
+    GLuint m_colorBuffer = 0;
+    GLuint m_depthBuffer = 0;
+
+    GLuint m_pixelBuffers[PBO_COUNT] = {};
+    GLsync m_fences[PBO_COUNT] = {};
+    unsigned int m_slotFrames[PBO_COUNT] = {};
+    unsigned int m_framesCaptured = 0;
+
+    ThreadPool m_writer{1};
+    std::deque<std::future<void>> m_pendingWrites;
+};
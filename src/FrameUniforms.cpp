@@ -0,0 +1,30 @@
+#include "FrameUniforms.hpp"
+#include "Shader.hpp"
+
+void FrameUniforms::update(const Camera& camera, const Light& light, RenderState& state)
+{
+    if (!m_UBO)
+    {
+        glGenBuffers(1, &m_UBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    Block block;
+    block.projection = camera.getProjectionMatrix();
+    block.view = camera.getViewMatrix();
+    block.viewPos = glm::vec4(camera.getPosition(), 1.0f);
+    block.lightPos = glm::vec4(light.getPosition(), 1.0f);
+    block.lightColor = glm::vec4(light.getColor(), 1.0f);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::FRAME_BLOCK_BINDING, m_UBO);
+    state.countCalls(3);
+}
+
+void FrameUniforms::destroy()
+{
+    glDeleteBuffers(1, &m_UBO);
+    m_UBO = 0;
+}
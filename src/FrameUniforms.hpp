@@ -0,0 +1,32 @@
+#pragma once
+
+#include <glad.h>
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+#include "Light.hpp"
+#include "RenderState.hpp"
+
+// Uniform buffer behind the "Frame" block of every shader: camera matrices and position plus the
+// light, written once per frame instead of once per object and pass
+class FrameUniforms
+{
+public:
+    // Creates the buffer on first use and binds it to Shader::FRAME_BLOCK_BINDING; the GL calls are counted in state
+    void update(const Camera& camera, const Light& light, RenderState& state);
+    void destroy();
+
+private:
+    // std140 layout of the block; vec3 members take 16 bytes each
+    struct Block
+    {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::vec4 viewPos;
+        glm::vec4 lightPos;
+        glm::vec4 lightColor;
+    };
+
+private:
+    GLuint m_UBO = 0;
+};
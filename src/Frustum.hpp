@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Aabb.hpp"
+
+// View frustum as six planes taken from a projection * view matrix, normals pointing inward
+struct Frustum
+{
+    glm::vec4 planes[6]; // inside where dot(xyz, p) + w >= 0
+
+    explicit Frustum(const glm::mat4& viewProjection)
+    {
+        // Rows of the clip transform: x, y and z each lie within [-w, w] inside the frustum
+        const glm::mat4 rows = glm::transpose(viewProjection);
+        planes[0] = rows[3] + rows[0];
+        planes[1] = rows[3] - rows[0];
+        planes[2] = rows[3] + rows[1];
+        planes[3] = rows[3] - rows[1];
+        planes[4] = rows[3] + rows[2];
+        planes[5] = rows[3] - rows[2];
+    }
+
+    // Tests the box corner furthest along each plane normal; conservative, so boxes just outside
+    // a frustum corner can still pass
+    bool intersects(const Aabb& box) const
+    {
+        for (const glm::vec4& plane : planes)
+        {
+            const glm::vec3 normal(plane);
+            const glm::vec3 corner = glm::mix(box.min, box.max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+            if (glm::dot(normal, corner) + plane.w < 0.0f) return false;
+        }
+        return true;
+    }
+};
@@ -82,7 +82,8 @@ void DebugWindow::displaySceneSelector(
 }
 
 void DebugWindow::displayPerformance(
-    int frameDuration
+    int frameDuration,
+    const RenderState::Stats& renderStats
 )
 {
     ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Performance");
@@ -91,6 +92,8 @@ void DebugWindow::displayPerformance(
     float fps = 1000.0f / static_cast<float>(frameDuration);
     ImGui::Text("Frame Duration: %.3f ms", static_cast<float>(frameDuration));
     ImGui::Text("FPS: %.1f", fps);
+    ImGui::Text("GL Calls: %u (%u redundant skipped)", renderStats.calls, renderStats.skipped);
+    ImGui::Text("Draws: %u, Vertex Uploads: %u", renderStats.draws, renderStats.uploads);
 
     m_fpsHistory.push_back(fps);
     if (m_fpsHistory.size() > 120.0f) {
@@ -199,8 +202,22 @@ void DebugWindow::displayXPBDParameters(
         ImGui::Checkbox("Enable Volume Constraints", &enableVolumeConstraints);
     }
 
-    // bool& enableEnvCollisionConstraints = scene.enableEnvCollisionConstraints();
-    // ImGui::Checkbox("Enable Collision Constraints", &enableEnvCollisionConstraints);
+    bool& enableEnvCollisionConstraints = scene.enableEnvCollisionConstraints();
+    ImGui::Checkbox("Enable Collision Constraints", &enableEnvCollisionConstraints);
+
+    bool& enableSelfCollisionConstraints = scene.enableSelfCollisionConstraints();
+    ImGui::Checkbox("Enable Self Collision", &enableSelfCollisionConstraints);
+
+    bool& enableObjectCollisionConstraints = scene.enableObjectCollisionConstraints();
+    ImGui::Checkbox("Enable Object Collision", &enableObjectCollisionConstraints);
+
+    ImGui::Dummy(ImVec2(0.0f, 5.0f));
+
+    float& contactMargin = scene.getContactMargin();
+    ImGui::Text("Contact Margin:");
+    ImGui::PushItemWidth(ImGui::GetContentRegionAvail().x - 1);
+    ImGui::SliderFloat("##Contact Margin", &contactMargin, 0.0f, 0.5f);
+    ImGui::PopItemWidth();
 
     ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
@@ -237,6 +254,22 @@ void DebugWindow::displayXPBDParameters(
     }
 }
 
+void DebugWindow::displayDebugDraw(
+    Scene& scene
+)
+{
+    ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), "Debug Draw");
+    ImGui::Dummy(ImVec2(0.0f, 5.0f));
+
+    DebugDraw::Options& options = scene.getDebugDrawOptions();
+    ImGui::Checkbox("Object Bounds", &options.bounds);
+    ImGui::Checkbox("BVH Nodes", &options.bvh);
+    ImGui::Checkbox("Contacts", &options.contacts);
+    ImGui::Checkbox("Constraint Strain", &options.constraintStrain);
+
+    ImGui::Separator();
+}
+
 void DebugWindow::displaySceneReset(
     Scene& scene
 )
@@ -245,9 +278,7 @@ void DebugWindow::displaySceneReset(
     ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
     if (ImGui::Button("Reset Scene (or press R)##ResetScene") || ImGui::IsKeyPressed(ImGuiKey_R)) {
-        for (auto& obj : scene.getObjects()) {
-            obj->resetVertexTransforms();
-        }
+        scene.resetObjects();
     }
 
     ImGui::Dummy(ImVec2(0.0f, 5.0f));
@@ -297,23 +328,23 @@ void DebugWindow::displayPolygonMode(
     ImGui::TreePop();
 }
 
-void DebugWindow::displayNormalShaders(
+void DebugWindow::displayNormals(
     size_t objectIndex,
     Object* object
 )
 {
-    if (!ImGui::TreeNode(("Normal Shaders##" + std::to_string(objectIndex)).c_str())) {
+    if (!ImGui::TreeNode(("Normals##" + std::to_string(objectIndex)).c_str())) {
         return;
     }
 
-    bool enableVertexNormals = object->getEnableVertexNormalShader();
-    if (ImGui::Checkbox(("Vertex Normals##" + std::to_string(objectIndex)).c_str(), &enableVertexNormals)) {
-        object->setEnableVertexNormalShader(enableVertexNormals);
+    bool showVertexNormals = object->getShowVertexNormals();
+    if (ImGui::Checkbox(("Vertex Normals##" + std::to_string(objectIndex)).c_str(), &showVertexNormals)) {
+        object->setShowVertexNormals(showVertexNormals);
     }
 
-    bool enableFaceNormals = object->getEnableFaceNormalShader();
-    if (ImGui::Checkbox(("Face Normals##" + std::to_string(objectIndex)).c_str(), &enableFaceNormals)) {
-        object->setEnableFaceNormalShader(enableFaceNormals);
+    bool showFaceNormals = object->getShowFaceNormals();
+    if (ImGui::Checkbox(("Face Normals##" + std::to_string(objectIndex)).c_str(), &showFaceNormals)) {
+        object->setShowFaceNormals(showFaceNormals);
     }
 
     ImGui::TreePop();
@@ -358,6 +389,7 @@ void DebugWindow::displaySceneObjects(
         ImGui::Text("Vertices: %zu", vertexCount);
         ImGui::Text("Edges: %zu", edgeCount);
         ImGui::Text("Triangles: %zu", triangleCount);
+        ImGui::Text("Vertex Cache ACMR: %.3f", mesh.getCacheMissRatio());
         ImGui::Dummy(ImVec2(0.0f, 5.0f));
 
         float distanceEnergy = object->getDistanceConstraintEnergy();
@@ -369,7 +401,7 @@ void DebugWindow::displaySceneObjects(
 
         displayVertexTransforms(i, object);
         displayPolygonMode(i, object);
-        displayNormalShaders(i, object);
+        displayNormals(i, object);
     }
 }
 
@@ -386,10 +418,11 @@ void DebugWindow::update(
     ImGui::Begin("Debug");
 
     displaySceneSelector(sceneManager);
-    displayPerformance(frameDuration);
+    displayPerformance(frameDuration, scene.getRenderStats());
     displayCamera(scene.getCamera());
     displayExternalForces(scene);
     displayXPBDParameters(scene);
+    displayDebugDraw(scene);
     displaySceneReset(scene);
     displaySceneObjects(scene);
 
@@ -37,14 +37,15 @@ private:
 
 private:
     void displaySceneSelector(SceneManager& sceneManager);
-    void displayPerformance(int frameDuration);
+    void displayPerformance(int frameDuration, const RenderState::Stats& renderStats);
     void displayCamera(Camera* camera);
     void displayExternalForces(Scene& scene);
     void displayXPBDParameters(Scene& scene);
+    void displayDebugDraw(Scene& scene);
     void displaySceneReset(Scene& scene);
     void displayPolygonMode(size_t objectIndex, Object* object);
     void displayObjectPanel(size_t objectIndex, Object* object);
-    void displayNormalShaders(size_t objectIndex, Object* object);
+    void displayNormals(size_t objectIndex, Object* object);
     void displayVertexTransforms(size_t objectIndex, Object* object);
     void displaySceneObjects(Scene& scene);
 };
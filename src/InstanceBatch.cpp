@@ -0,0 +1,174 @@
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "InstanceBatch.hpp"
+#include "Object.hpp"
+
+namespace
+{
+    // Unit 0 keeps the surface texture
+    constexpr GLint VERTEX_TEXTURE_UNIT = 1;
+
+    size_t getMaxTextureBufferSize()
+    {
+        static GLint maxTexels = 0;
+        if (!maxTexels) glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+        return static_cast<size_t>(maxTexels);
+    }
+}
+
+bool InstanceBatch::draw(const std::vector<Object*>& members, GLuint texture, RenderState& state, const Shader& shader)
+{
+    if (members != m_members)
+    {
+        if (!m_VAO || members.size() > m_capacity)
+        {
+            if (!rebuild(members)) return false;
+            state.invalidateVertexArray();
+        }
+        else
+        {
+            setMembers(members);
+        }
+    }
+
+    state.useProgram(shader.getID());
+    state.bindVertexArray(m_VAO);
+
+    bool verticesChanged = false;
+    bool colorsChanged = false;
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        const Object& member = *m_members[i];
+        uint64_t version = member.getMesh().getVertexVersion();
+        if (version != m_vertexVersions[i])
+        {
+            m_vertexVersions[i] = version;
+            verticesChanged = true;
+        }
+        if (member.getColor() != m_colors[i])
+        {
+            m_colors[i] = member.getColor();
+            colorsChanged = true;
+        }
+    }
+
+    // A segment holds all members, so one moving member re-streams the lot; resting ones cost a memcpy
+    if (verticesChanged)
+    {
+        gatherVertices();
+        m_vertexSegment = m_vertexStream.write(m_staging.data(), state);
+    }
+
+    if (colorsChanged)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_colors.size() * sizeof(glm::vec3), m_colors.data());
+        state.countCalls(2);
+    }
+
+    if (texture) state.bindTexture(texture);
+    state.setUniform(shader, "hasTexture", texture ? 1 : 0);
+    state.setUniform(shader, "vertices", VERTEX_TEXTURE_UNIT);
+    state.setUniform(shader, "vertexOffset", static_cast<int>(m_vertexSegment * m_staging.size()));
+    state.setUniform(shader, "vertexCount", static_cast<int>(m_vertexCount));
+
+    glActiveTexture(GL_TEXTURE0 + VERTEX_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_vertexTexture);
+    glActiveTexture(GL_TEXTURE0);
+    state.countCalls(3);
+
+    glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0, static_cast<GLsizei>(m_members.size()));
+    state.countDraw();
+    m_vertexStream.fence(m_vertexSegment, state);
+    return true;
+}
+
+bool InstanceBatch::rebuild(const std::vector<Object*>& members)
+{
+    destroy();
+
+    const Mesh& mesh = members.front()->getMesh();
+    const size_t vertexCount = mesh.getStreamVertices().size();
+    const size_t capacity = std::bit_ceil(members.size());
+    if (vertexCount * capacity * VertexStream::SEGMENT_COUNT > getMaxTextureBufferSize()) return false;
+
+    m_capacity = capacity;
+    m_vertexCount = vertexCount;
+    m_indexCount = static_cast<GLsizei>(mesh.getIndices().size());
+    m_staging.assign(m_vertexCount * m_capacity, Mesh::StreamVertex{});
+
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_texCoordVBO);
+    glGenBuffers(1, &m_instanceVBO);
+    glGenBuffers(1, &m_EBO);
+    glBindVertexArray(m_VAO);
+
+    std::vector<glm::vec2> texCoords;
+    texCoords.reserve(m_vertexCount);
+    for (const auto& vertex : mesh.getVertices())
+    {
+        texCoords.push_back(vertex.texCoords);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_texCoordVBO);
+    glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glVertexAttribDivisor(3, 1);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.getIndices().size() * sizeof(unsigned int), mesh.getIndices().data(), GL_STATIC_DRAW);
+
+    // Positions and packed normals, read as four uints per vertex
+    m_vertexStream.create(m_staging.size() * sizeof(Mesh::StreamVertex), m_staging.data());
+    m_vertexSegment = 0;
+    glGenTextures(1, &m_vertexTexture);
+    glActiveTexture(GL_TEXTURE0 + VERTEX_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_vertexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, m_vertexStream.getBuffer());
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(0);
+
+    setMembers(members);
+    return true;
+}
+
+void InstanceBatch::setMembers(const std::vector<Object*>& members)
+{
+    // Versions and colors no member can match, so the next draw streams and uploads everything
+    m_members = members;
+    m_vertexVersions.assign(m_members.size(), std::numeric_limits<uint64_t>::max());
+    m_colors.assign(m_members.size(), glm::vec3(std::numeric_limits<float>::quiet_NaN()));
+}
+
+void InstanceBatch::gatherVertices()
+{
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        const auto& vertices = m_members[i]->getMesh().getStreamVertices();
+        std::memcpy(m_staging.data() + i * m_vertexCount, vertices.data(), m_vertexCount * sizeof(Mesh::StreamVertex));
+    }
+}
+
+void InstanceBatch::destroy()
+{
+    if (m_VAO)
+    {
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_texCoordVBO);
+        glDeleteBuffers(1, &m_instanceVBO);
+        glDeleteBuffers(1, &m_EBO);
+        glDeleteTextures(1, &m_vertexTexture);
+        m_vertexStream.destroy();
+    }
+    m_VAO = m_texCoordVBO = m_instanceVBO = m_EBO = m_vertexTexture = 0;
+    m_capacity = 0;
+    m_members.clear();
+}
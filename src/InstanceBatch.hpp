@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glad.h>
+#include <glm/glm.hpp>
+
+#include "Mesh.hpp"
+#include "RenderState.hpp"
+#include "Shader.hpp"
+#include "VertexStream.hpp"
+
+class Object;
+
+// Objects sharing a mesh topology drawn with one glDrawElementsInstanced. Every member's stream
+// vertices sit back to back in one streamed buffer, which the vertex shader reads through a
+// texture buffer at instance * vertexCount, so deforming members need no per-object VAO or draw.
+// Members' colors are per-instance attributes; indices and texture coordinates are shared.
+class InstanceBatch
+{
+public:
+    // Draws the members, all using the same mesh, texture and draw state. Buffers are sized for a
+    // power of two members, so objects entering and leaving the view only re-stream, and are
+    // rebuilt when outgrown. Returns false when the members don't fit in a texture buffer, in
+    // which case they have to be drawn one by one.
+    bool draw(const std::vector<Object*>& members, GLuint texture, RenderState& state, const Shader& shader);
+    void destroy();
+
+private:
+    bool rebuild(const std::vector<Object*>& members);
+    void setMembers(const std::vector<Object*>& members);
+    void gatherVertices();
+
+private:
+    std::vector<Object*> m_members;
+    std::vector<uint64_t> m_vertexVersions;
+    std::vector<glm::vec3> m_colors;
+    std::vector<Mesh::StreamVertex> m_staging;
+    size_t m_capacity = 0;
+    size_t m_vertexCount = 0;
+    GLsizei m_indexCount = 0;
+
+    GLuint m_VAO = 0;
+    GLuint m_EBO = 0;
+    GLuint m_texCoordVBO = 0;
+    GLuint m_instanceVBO = 0;
+    GLuint m_vertexTexture = 0;
+    VertexStream m_vertexStream;
+    unsigned int m_vertexSegment = 0;
+};
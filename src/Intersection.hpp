@@ -0,0 +1,66 @@
+#pragma once
+
+#include <optional>
+#include <glm/glm.hpp>
+
+namespace Intersection
+{
+    // Barycentric coordinates of point projected onto the plane of (a, b, c); none for degenerate triangles
+    inline std::optional<glm::vec3> barycentric(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& point)
+    {
+        glm::vec3 e0 = b - a, e1 = c - a, d = point - a;
+        float d00 = glm::dot(e0, e0), d01 = glm::dot(e0, e1), d11 = glm::dot(e1, e1);
+        float d20 = glm::dot(d, e0), d21 = glm::dot(d, e1);
+        float denominator = d00 * d11 - d01 * d01;
+        if (denominator <= 0.0f) return std::nullopt;
+
+        float v = (d11 * d20 - d01 * d21) / denominator;
+        float w = (d00 * d21 - d01 * d20) / denominator;
+        return glm::vec3(1.0f - v - w, v, w);
+    }
+
+    // Parameters s, u in [0, 1] of the closest points p1 + s (q1 - p1) and p2 + u (q2 - p2) of two segments
+    inline void closestSegmentParameters(
+        const glm::vec3& p1, const glm::vec3& q1,
+        const glm::vec3& p2, const glm::vec3& q2,
+        float& s, float& u
+    )
+    {
+        glm::vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+        float a = glm::dot(d1, d1), e = glm::dot(d2, d2), f = glm::dot(d2, r);
+        s = u = 0.0f;
+        if (a <= 0.0f && e <= 0.0f) return;
+        if (a <= 0.0f)
+        {
+            u = glm::clamp(f / e, 0.0f, 1.0f);
+            return;
+        }
+
+        float c = glm::dot(d1, r);
+        if (e <= 0.0f)
+        {
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+            return;
+        }
+
+        float b = glm::dot(d1, d2);
+        float denominator = a * e - b * b;
+        s = denominator > 0.0f ? glm::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+        u = (b * s + f) / e;
+        if (u < 0.0f)
+        {
+            u = 0.0f;
+            s = glm::clamp(-c / a, 0.0f, 1.0f);
+        }
+        else if (u > 1.0f)
+        {
+            u = 1.0f;
+            s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+        }
+    }
+
+    inline bool isInside(const glm::vec3& weights, float tolerance = 0.0f)
+    {
+        return weights.x >= -tolerance && weights.y >= -tolerance && weights.z >= -tolerance;
+    }
+}
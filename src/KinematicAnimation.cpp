@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <cmath>
+
+#include "KinematicAnimation.hpp"
+
+KinematicAnimation::KinematicAnimation(std::vector<Keyframe> keyframes, bool loop)
+    : m_keyframes(std::move(keyframes)),
+      m_loop(loop)
+{
+    std::stable_sort(m_keyframes.begin(), m_keyframes.end(), [](const Keyframe& a, const Keyframe& b) {
+        return a.time < b.time;
+    });
+}
+
+KinematicAnimation::Pose KinematicAnimation::sample(float time) const
+{
+    if (m_keyframes.empty()) return {};
+
+    const float start = m_keyframes.front().time;
+    const float duration = m_keyframes.back().time - start;
+    if (m_loop && duration > 0.0f)
+    {
+        time = start + std::fmod(time - start, duration);
+        if (time < start) time += duration;
+    }
+
+    if (time <= start) return m_keyframes.front().pose;
+    if (time >= m_keyframes.back().time) return m_keyframes.back().pose;
+
+    auto next = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), time, [](float t, const Keyframe& keyframe) {
+        return t < keyframe.time;
+    });
+    const Keyframe& b = *next;
+    const Keyframe& a = *(next - 1);
+    float t = (time - a.time) / (b.time - a.time);
+
+    Pose pose;
+    pose.position = glm::mix(a.pose.position, b.pose.position, t);
+    pose.rotation = glm::slerp(a.pose.rotation, b.pose.rotation, t);
+    return pose;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Rigid motion of a kinematic object, interpolated linearly in position and spherically in
+// rotation between keyframes. Rotations take the short way round, so a full turn needs at
+// least three keyframes.
+class KinematicAnimation
+{
+public:
+    struct Pose
+    {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    };
+
+    struct Keyframe
+    {
+        float time;
+        Pose pose;
+    };
+
+    KinematicAnimation() = default;
+    // Keyframes are sorted by time; looping wraps from the last keyframe back to the first
+    KinematicAnimation(std::vector<Keyframe> keyframes, bool loop);
+
+    bool empty() const { return m_keyframes.empty(); }
+
+    // Held at the first and last keyframes outside their range unless looping
+    Pose sample(float time) const;
+
+private:
+    std::vector<Keyframe> m_keyframes;
+    bool m_loop = false;
+};
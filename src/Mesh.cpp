@@ -1,14 +1,25 @@
-#include <set>
+#include <algorithm>
+#include <filesystem>
+#include <glm/gtc/packing.hpp>
 
 #include "logger.hpp"
-#include "Object.hpp"
+#include "ObjParser.hpp"
+#include "PositionWelder.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshAdjacency.hpp"
 #include "Mesh.hpp"
 
+namespace
+{
+    // Below this, splitting normal computation across the pool costs more than it saves
+    constexpr size_t MIN_PARALLEL_TRIANGLES = 4096;
+}
 
-void Mesh::constructVertices(const aiMesh* mesh)
+void Mesh::constructVertices(const aiMesh* mesh, Geometry& geometry)
 {
-    m_vertexToPositionIndex.clear();
-    m_vertexToPositionIndex.reserve(mesh->mNumVertices);
+    geometry.vertexToPositionIndex.clear();
+    geometry.vertexToPositionIndex.reserve(mesh->mNumVertices);
+    PositionWelder welder(geometry.positions, mesh->mNumVertices);
 
     for (size_t i = 0; i < mesh->mNumVertices; ++i)
     {
@@ -22,20 +33,7 @@ void Mesh::constructVertices(const aiMesh* mesh)
         vertex.position = vector;
 
         // Keep track of only unique vertex positions
-        auto pit = std::find(m_positions.begin(), m_positions.end(), vertex.position);
-        int posIdx;
-        if (pit == m_positions.end())
-        {
-            posIdx = m_positions.size();
-            m_positions.push_back(vertex.position);
-        }
-        else
-        {
-            posIdx = std::distance(m_positions.begin(), pit);
-        }
-
-        m_positionToVertexIndices[posIdx].push_back(i);
-        m_vertexToPositionIndex.push_back(posIdx);
+        geometry.vertexToPositionIndex.push_back(welder.weld(vertex.position));
 
         // Vertex texture coordinates
         if(mesh->mTextureCoords[0])
@@ -56,128 +54,82 @@ void Mesh::constructVertices(const aiMesh* mesh)
         vector.z = mesh->mNormals[i].z;
         vertex.normal = vector;
 
-        m_vertices.push_back(vertex);
+        geometry.vertices.push_back(vertex);
     }
 }
 
-void Mesh::constructIndices(const aiMesh* mesh)
+void Mesh::constructIndices(const aiMesh* mesh, Geometry& geometry)
 {
-    m_indices.clear();
+    geometry.indices.clear();
     size_t totalIndices = 0;
     for (size_t i = 0; i < mesh->mNumFaces; ++i)
     {
         totalIndices += mesh->mFaces[i].mNumIndices;
     }
 
-    m_indices.reserve(totalIndices);
+    geometry.indices.reserve(totalIndices);
     for(size_t i = 0; i < mesh->mNumFaces; i++)
     {
         aiFace face = mesh->mFaces[i];
         for(unsigned int j = 0; j < face.mNumIndices; j++)
         {
-            m_indices.push_back(face.mIndices[j]);
+            geometry.indices.push_back(face.mIndices[j]);
         }
     }
 }
 
-void Mesh::constructMouseDistanceConstraintVertices(const aiMesh* mesh)
+void Mesh::constructMouseDistanceConstraintVertices()
 {
-    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        const aiFace& face = mesh->mFaces[i];
-        if (face.mNumIndices == 3) {
-            Triangle triangle;
-            triangle.v1 = m_vertexToPositionIndex[face.mIndices[0]];
-            triangle.v2 = m_vertexToPositionIndex[face.mIndices[1]];
-            triangle.v3 = m_vertexToPositionIndex[face.mIndices[2]];
-            mouseDistanceConstraints.triangles.push_back(triangle);
-        }
-    }
+    mouseDistanceConstraints.triangles = m_adjacency->getTriangles();
 }
 
-void Mesh::constructDistanceConstraintVertices(const aiMesh* mesh)
+void Mesh::constructDistanceConstraintVertices()
 {
-    struct UniqueEdge
-    {
-        unsigned int v1;
-        unsigned int v2;
-        bool operator==(const UniqueEdge& other) const
-        {
-            return (v1 == other.v1 && v2 == other.v2) || (v1 == other.v2 && v2 == other.v1);
-        }
-        bool operator<(const UniqueEdge& other) const
-        {
-            int a1 = std::min(v1, v2), a2 = std::max(v1, v2);
-            int b1 = std::min(other.v1, other.v2), b2 = std::max(other.v1, other.v2);
-            return std::tie(a1, a2) < std::tie(b1, b2);
-        }
-    };
+    distanceConstraints.edges = m_adjacency->getEdges();
+}
 
-    std::set<UniqueEdge> uniqueEdges;
-    for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
+void Mesh::constructVolumeConstraintVertices()
+{
+    volumeConstraints.triangles = m_adjacency->getTriangles();
+}
+
+void Mesh::constructEnvCollisionConstraintVertices()
+{
+    // Every welded position referenced by a render vertex
+    for (unsigned int i = 0; i < m_positions.size(); ++i)
     {
-        const aiFace& face = mesh->mFaces[i];
-        if (face.mNumIndices == 3)
+        if (!m_adjacency->getPositionVertices(i).empty())
         {
-            unsigned int idx[3];
-            for (int j = 0; j < 3; ++j)
-            {
-                idx[j] = m_vertexToPositionIndex[face.mIndices[j]];
-            }
-            uniqueEdges.insert(UniqueEdge{idx[0], idx[1]});
-            uniqueEdges.insert(UniqueEdge{idx[1], idx[2]});
-            uniqueEdges.insert(UniqueEdge{idx[2], idx[0]});
+            envCollisionConstraintVertices.push_back(i);
         }
     }
 
-    for (const auto& e : uniqueEdges)
+    // Edges of the surface triangles; interior tetrahedron edges can't touch anything
+    const auto& edges = m_adjacency->getEdges();
+    for (unsigned int e = 0; e < edges.size(); ++e)
     {
-        Edge edge;
-        edge.v1 = e.v1;
-        edge.v2 = e.v2;
-        distanceConstraints.edges.push_back(edge);
-    }
-}
-
-void Mesh::constructVolumeConstraintVertices(const aiMesh* mesh)
-{
-    for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        const aiFace& face = mesh->mFaces[i];
-        if (face.mNumIndices == 3) {
-            Triangle triangle;
-            triangle.v1 = m_vertexToPositionIndex[face.mIndices[0]];
-            triangle.v2 = m_vertexToPositionIndex[face.mIndices[1]];
-            triangle.v3 = m_vertexToPositionIndex[face.mIndices[2]];
-            volumeConstraints.triangles.push_back(triangle);
+        if (!m_adjacency->getEdgeTriangles(e).empty())
+        {
+            envCollisionConstraintEdges.push_back(edges[e]);
         }
     }
 }
 
-void Mesh::constructEnvCollisionConstraintVertices()
+bool Mesh::loadObjData(const std::string& filePath, ThreadPool* threadPool)
 {
-    std::set<unsigned int> uniqueIndices;
-
-    // Directly iterate through m_vertices
-    for (size_t i = 0; i < m_vertices.size(); ++i)
+    try
     {
-        const glm::vec3& pos = m_vertices[i].position;
-
-        // Find in m_positions
-        auto it = std::find(m_positions.begin(), m_positions.end(), pos);
-        if (it != m_positions.end())
-        {
-            unsigned int idx = static_cast<unsigned int>(std::distance(m_positions.begin(), it));
-            uniqueIndices.insert(idx);
-        }
+        buildFromGeometry(ObjParser::parse(filePath, threadPool));
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        logger::warning("OBJ parser failed on '{}', falling back to ASSIMP: {}", filePath, e.what());
+        return false;
     }
-
-    envCollisionConstraintVertices.insert(
-        envCollisionConstraintVertices.end(),
-        uniqueIndices.begin(),
-        uniqueIndices.end()
-    );
 }
 
-void Mesh::loadObjData(const std::string& filePath)
+void Mesh::loadAssimpData(const std::string& filePath)
 {
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(
@@ -193,30 +145,52 @@ void Mesh::loadObjData(const std::string& filePath)
 
     const aiMesh* mesh = scene->mMeshes[0];
 
-    // Construct m_vertices and m_indices
-    constructVertices(mesh);
-    constructIndices(mesh);
-
-    // construct vertices used for specific constraints
-    constructMouseDistanceConstraintVertices(mesh);
-    constructDistanceConstraintVertices(mesh);
-    constructVolumeConstraintVertices(mesh);
-    constructEnvCollisionConstraintVertices();
+    // Construct vertices and indices
+    Geometry geometry;
+    constructVertices(mesh, geometry);
+    constructIndices(mesh, geometry);
+    buildFromGeometry(std::move(geometry));
 }
 
-void Mesh::setCandidateObjectMeshes(const std::vector<Object*>& objects)
+void Mesh::loadMeshData(const std::string& filePath, ThreadPool* threadPool)
 {
-    for (auto* obj : objects)
+    // Wavefront files take the dedicated parser, everything else goes through ASSIMP
+    std::string extension = std::filesystem::path(filePath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".obj" && loadObjData(filePath, threadPool))
     {
-        // Skip null objects
-        if (!obj) continue;
-
-        const Mesh& objMesh = obj->getMesh();
-        if (&objMesh != this)
-        {
-            m_candidateObjectMeshes.push_back(&objMesh);
-        }
+        return;
     }
+
+    loadAssimpData(filePath);
+}
+
+void Mesh::buildFromGeometry(Geometry geometry)
+{
+    // Loaders emit particles in file order; renumber them so the solver's gathers stay local
+    auto [bandwidthBefore, bandwidthAfter] = MeshOptimizer::reorderForLocality(geometry);
+    logger::debug("Reordered '{}' particles, bandwidth {} -> {}", m_name, bandwidthBefore, bandwidthAfter);
+
+    // Loaders also keep the file's triangle order; reorder it for the post-transform vertex cache
+    auto [missRatioBefore, missRatioAfter] = MeshOptimizer::optimizeVertexCache(geometry);
+    m_cacheMissRatio = missRatioAfter;
+    logger::info("Reordered '{}' triangles, vertex cache misses per triangle {} -> {}", m_name, missRatioBefore, missRatioAfter);
+
+    m_positions = std::move(geometry.positions);
+    m_vertices = std::move(geometry.vertices);
+    m_vertexToPositionIndex = std::move(geometry.vertexToPositionIndex);
+    m_indices = std::move(geometry.indices);
+    m_tetrahedra = std::move(geometry.tetrahedra);
+    packStreamVertices();
+
+    m_adjacency = std::make_shared<const MeshAdjacency>(m_positions.size(), m_indices, m_vertexToPositionIndex, m_tetrahedra);
+    m_isClosed = m_adjacency->isClosed();
+
+    // construct vertices used for specific constraints
+    constructMouseDistanceConstraintVertices();
+    constructDistanceConstraintVertices();
+    constructVolumeConstraintVertices();
+    constructEnvCollisionConstraintVertices();
 }
 
 void Mesh::constructDistanceConstraints()
@@ -281,213 +255,180 @@ void Mesh::constructVolumeConstraints(float& k)
     });
 }
 
-// TODO : fixme
-void Mesh::constructEnvCollisionConstraints()
-{
-    // for (size_t meshIdx = 0; meshIdx < m_candidateObjectMeshes.size(); ++meshIdx)
-    // {
-    //     const auto& cMesh = m_candidateObjectMeshes[meshIdx];
-    //     if (!cMesh) continue;
-
-    //     // Create a new EnvCollisionConstraints for this mesh
-    //     EnvCollisionConstraints envCollisionConstraints;
-    //     envCollisionConstraints.candidateMesh = cMesh;
-
-    //     // Get vertices from the candidate mesh
-    //     const auto& vertices = cMesh->getVertices();
-
-    //     // Loop through source vertices
-    //     for (const auto& v : envCollisionConstraintVertices)
-    //     {
-    //         // Only process every third vertex (first vertex of each triangle)
-    //         for (size_t vIdx = 0; vIdx < vertices.size(); vIdx += 3)
-    //         {
-    //             // Store the index where this constraint will be added
-    //             size_t constraintIdx = envCollisionConstraints.C.size();
-
-    //             // Add to map of vertex to constraint indices
-    //             envCollisionConstraints.vertexToConstraints[v].push_back(constraintIdx);
-
-    //             // Create constraint function
-    //             envCollisionConstraints.C.push_back(
-    //                 [v, vIdx, cMesh=cMesh](const std::vector<glm::vec3>& x) -> float {
-    //                     const auto& cVertex = cMesh->getVertices()[vIdx];
-    //                     float dot = glm::dot(cVertex.normal, x[v] - cVertex.position);
-    //                     return dot;
-    //                 });
-
-    //             // Create gradient function
-    //             envCollisionConstraints.gradC.push_back(
-    //                 [v, vIdx, cMesh=cMesh](const std::vector<glm::vec3>& x) -> std::vector<glm::vec3> {
-    //                     const auto& cVertex = cMesh->getVertices()[vIdx];
-    //                     return { cVertex.normal };
-    //                 });
-
-    //             // Store affected vertex
-    //             envCollisionConstraints.vertices.push_back(v);
-    //         }
-    //     }
-
-    //     // Only add if we have constraints
-    //     if (!envCollisionConstraints.C.empty())
-    //     {
-    //         perEnvCollisionConstraints.push_back(envCollisionConstraints);
-    //     }
-    // }
-}
-
 void Mesh::initVerticesBuffer()
 {
     glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
+    glGenBuffers(1, &m_texCoordVBO);
     glGenBuffers(1, &m_EBO);
 
     glBindVertexArray(m_VAO);
 
-    // Bind and set VBO
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), &m_vertices[0], GL_DYNAMIC_DRAW);
-
-    // Bind and set EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), &m_indices[0], GL_STATIC_DRAW);
+    // Texture coordinates, uploaded once
+    std::vector<glm::vec2> texCoords;
+    texCoords.reserve(m_vertices.size());
+    for (const auto& vertex : m_vertices)
+    {
+        texCoords.push_back(vertex.texCoords);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_texCoordVBO);
+    glBufferData(GL_ARRAY_BUFFER, texCoords.size() * sizeof(glm::vec2), texCoords.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
 
-    // Position attribute
+    // Positions and normals, streamed; the attributes point at whichever segment was written last
+    m_vertexStream.create(m_streamVertices.size() * sizeof(StreamVertex), m_streamVertices.data());
+    m_vertexSegment = 0;
+    m_verticesDirty = false;
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-
-    // Normal attribute
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    setStreamAttributes(m_vertexSegment);
 
-    // Texture coordinate attribute
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+    // Bind and set EBO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), &m_indices[0], GL_STATIC_DRAW);
 
     glBindVertexArray(0);
 }
 
-void Mesh::initNormalBuffers()
+void Mesh::setStreamAttributes(unsigned int segment)
 {
-    m_normalLines.vertexCount = m_vertices.size();
-    m_normalLines.faceCount = m_indices.size() / 3;
-    size_t totalLineVertices = m_normalLines.vertexCount + m_normalLines.faceCount;
+    size_t offset = segment * m_streamVertices.size() * sizeof(StreamVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexStream.getBuffer());
 
-    glGenVertexArrays(1, &m_normalLines.VAO);
-    glGenBuffers(1, &m_normalLines.VBO);
-
-    glBindVertexArray(m_normalLines.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_normalLines.VBO);
-
-    glBufferData(GL_ARRAY_BUFFER, totalLineVertices * 2 * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
+    // Position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(StreamVertex), (void*)(offset + offsetof(StreamVertex, position)));
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    // Normal attribute, unpacked to [-1, 1] by the GPU
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(StreamVertex), (void*)(offset + offsetof(StreamVertex, normal)));
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void Mesh::packStreamVertices()
+{
+    m_streamVertices.resize(m_vertices.size());
+    for (size_t i = 0; i < m_vertices.size(); ++i)
+    {
+        m_streamVertices[i].position = m_vertices[i].position;
+        m_streamVertices[i].normal = glm::packSnorm3x10_1x2(glm::vec4(m_vertices[i].normal, 0.0f));
+    }
 }
 
-Mesh::Mesh(const std::string& name, const std::string& meshPath)
+Mesh::Mesh(const std::string& name, const std::string& meshPath, ThreadPool* threadPool)
     : m_name(name),
       m_meshPath(meshPath),
       m_vertexNormalLength(0.1f),
       m_faceNormalLength(0.5f)
 {
-    loadObjData(meshPath);
-    initVerticesBuffer();
-    initNormalBuffers();
+    loadMeshData(meshPath, threadPool);
 }
 
-std::vector<glm::vec3> Mesh::calculateFaceNormals()
+Mesh::Mesh(const std::string& name, Geometry geometry)
+    : m_name(name),
+      m_meshPath(""),
+      m_vertexNormalLength(0.1f),
+      m_faceNormalLength(0.5f)
 {
-    std::vector<glm::vec3> faceNormals;
-    size_t numTriangles = m_indices.size() / 3;
-    faceNormals.reserve(numTriangles);
-
-    for (size_t i = 0; i + 2 < m_indices.size(); i += 3)
-    {
-        unsigned int idx0 = m_indices[i];
-        unsigned int idx1 = m_indices[i + 1];
-        unsigned int idx2 = m_indices[i + 2];
-
-        const glm::vec3& p_0 = m_vertices[idx0].position;
-        const glm::vec3& p_1 = m_vertices[idx1].position;
-        const glm::vec3& p_2 = m_vertices[idx2].position;
-
-        glm::vec3 faceNormal = glm::normalize(glm::cross(p_1 - p_0, p_2 - p_0));
-        faceNormals.push_back(faceNormal);
-    }
+    buildFromGeometry(std::move(geometry));
+}
 
-    return faceNormals;
+void Mesh::setHardEdges(bool hardEdges)
+{
+    m_hardEdges = hardEdges;
+    update();
 }
 
-void Mesh::update()
+void Mesh::update(ThreadPool* threadPool)
 {
-    // update m_vertices positions
-    size_t n = m_positions.size();
-    for (size_t i = 0; i < n; ++i)
+    const auto& triangles = m_adjacency->getTriangles();
+    m_faceNormals.resize(triangles.size());
+
+    auto computeFaceNormals = [this, &triangles](size_t begin, size_t end)
     {
-        const glm::vec3& updatedPosition = m_positions[i];
-        const auto& duplicates = m_positionToVertexIndices[i];
-        for (unsigned int idx : duplicates)
+        for (size_t t = begin; t < end; ++t)
         {
-            m_vertices[idx].position = updatedPosition;
+            const glm::vec3& x0 = m_positions[triangles[t].v1];
+            m_faceNormals[t] = glm::cross(m_positions[triangles[t].v2] - x0, m_positions[triangles[t].v3] - x0);
         }
-    }
-
+    };
 
-    std::vector<glm::vec3> updatedFaceNormals = calculateFaceNormals();
-    for (size_t i = 0, tri = 0; i + 2 < m_indices.size(); i += 3, ++tri)
+    // Summing unnormalised face normals weights each face by its area
+    auto computeVertexNormals = [this](size_t begin, size_t end)
     {
-        unsigned int idx0 = m_indices[i];
-        unsigned int idx1 = m_indices[i + 1];
-        unsigned int idx2 = m_indices[i + 2];
+        for (size_t v = begin; v < end; ++v)
+        {
+            unsigned int position = m_vertexToPositionIndex[v];
+            auto faces = m_hardEdges
+                ? m_adjacency->getRenderVertexTriangles(static_cast<unsigned int>(v))
+                : m_adjacency->getVertexTriangles(position);
 
-        glm::vec3& faceNormal = updatedFaceNormals[tri];
+            glm::vec3 normal(0.0f);
+            for (unsigned int t : faces)
+            {
+                normal += m_faceNormals[t];
+            }
+            float length = glm::length(normal);
 
-        m_vertices[idx0].normal = faceNormal;
-        m_vertices[idx1].normal = faceNormal;
-        m_vertices[idx2].normal = faceNormal;
+            Vertex& vertex = m_vertices[v];
+            vertex.position = m_positions[position];
+            if (length > 0.0f)
+            {
+                vertex.normal = normal / length;
+            }
+
+            m_streamVertices[v].position = vertex.position;
+            m_streamVertices[v].normal = glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.0f));
+        }
+    };
+
+    // Both passes write disjoint ranges, so each splits across the pool without locking
+    if (threadPool && triangles.size() >= MIN_PARALLEL_TRIANGLES)
+    {
+        threadPool->parallel_for_range(triangles.size(), computeFaceNormals);
+        threadPool->parallel_for_range(m_vertices.size(), computeVertexNormals);
+    }
+    else
+    {
+        computeFaceNormals(0, triangles.size());
+        computeVertexNormals(0, m_vertices.size());
     }
+
+    m_verticesDirty = true;
+    ++m_vertexVersion;
 }
 
-void Mesh::draw()
+void Mesh::draw(RenderState& state)
 {
-    glBindVertexArray(m_VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(Vertex), &m_vertices[0]);
+    if (!m_VAO)
+    {
+        initVerticesBuffer();
+        state.invalidateVertexArray();
+    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    state.bindVertexArray(m_VAO);
+
+    // Vertices that haven't changed since the last upload are drawn from the segment they're already in
+    if (m_verticesDirty)
+    {
+        m_vertexSegment = m_vertexStream.write(m_streamVertices.data(), state);
+        m_verticesDirty = false;
+        setStreamAttributes(m_vertexSegment);
+        state.countCalls(3);
+    }
 
     glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    state.countDraw();
+    m_vertexStream.fence(m_vertexSegment, state);
 }
 
-void Mesh::drawVertexNormals()
+void Mesh::addVertexNormals(DebugDraw& debugDraw, uint32_t color) const
 {
-    std::vector<glm::vec3> lineVertices;
-    lineVertices.reserve(m_normalLines.vertexCount * 2);
     for (const auto& v : m_vertices)
     {
-        lineVertices.push_back(v.position);
-        lineVertices.push_back(v.position + v.normal * m_vertexNormalLength);
+        debugDraw.addLine(v.position, v.position + v.normal * m_vertexNormalLength, color);
     }
-
-    glBindVertexArray(m_normalLines.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_normalLines.VBO);
-
-    glBufferSubData(GL_ARRAY_BUFFER, 0, lineVertices.size() * sizeof(glm::vec3), lineVertices.data());
-
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(lineVertices.size()));
-    glBindVertexArray(0);
 }
 
-void Mesh::drawFaceNormals()
+void Mesh::addFaceNormals(DebugDraw& debugDraw, uint32_t color) const
 {
-    std::vector<glm::vec3> lineVertices;
-    lineVertices.reserve(m_normalLines.faceCount * 2);
-
     for (size_t i = 0; i + 2 < m_indices.size(); i += 3)
     {
         unsigned int idx0 = m_indices[i];
@@ -495,28 +436,18 @@ void Mesh::drawFaceNormals()
         unsigned int idx2 = m_indices[i + 2];
 
         glm::vec3 centroid = (m_vertices[idx0].position + m_vertices[idx1].position + m_vertices[idx2].position) / 3.0f;
-        glm::vec3 normal = m_vertices[idx0].normal;
+        float area = glm::length(m_faceNormals[i / 3]);
+        glm::vec3 normal = area > 0.0f ? m_faceNormals[i / 3] / area : glm::vec3(0.0f);
 
-        lineVertices.push_back(centroid);
-        lineVertices.push_back(centroid + normal * m_faceNormalLength);
+        debugDraw.addLine(centroid, centroid + normal * m_faceNormalLength, color);
     }
-
-    glBindVertexArray(m_normalLines.VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_normalLines.VBO);
-
-    size_t vertexNormalsSize = m_normalLines.vertexCount * 2 * sizeof(glm::vec3);
-    glBufferSubData(GL_ARRAY_BUFFER, vertexNormalsSize, lineVertices.size() * sizeof(glm::vec3), lineVertices.data());
-
-    glDrawArrays(GL_LINES, static_cast<GLint>(m_normalLines.vertexCount * 2), static_cast<GLsizei>(lineVertices.size()));
-    glBindVertexArray(0);
 }
 
 void Mesh::destroy()
 {
     glDeleteVertexArrays(1, &m_VAO);
-    glDeleteBuffers(1, &m_VBO);
+    glDeleteBuffers(1, &m_texCoordVBO);
     glDeleteBuffers(1, &m_EBO);
-
-    glDeleteVertexArrays(1, &m_normalLines.VAO);
-    glDeleteBuffers(1, &m_normalLines.VBO);
+    m_vertexStream.destroy();
+    m_VAO = m_texCoordVBO = m_EBO = 0;
 }
\ No newline at end of file
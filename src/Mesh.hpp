@@ -1,6 +1,7 @@
 #pragma once
 
 #include <assimp/mesh.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <functional>
@@ -9,35 +10,55 @@
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
-#include <map>
+#include <memory>
+
+#include "DebugDraw.hpp"
+#include "RenderState.hpp"
+#include "ThreadPool.hpp"
+#include "VertexStream.hpp"
 
 using Constraint = std::function<float(const std::vector<glm::vec3>&)>;
 using ConstraintGradient = std::function<std::vector<glm::vec3>(const std::vector<glm::vec3>&)>;
 
-class Object; // Forward declaration
+class MeshAdjacency;
 class Mesh
 {
 public:
     Mesh() = default;
     Mesh(
         const std::string& name,
-        const std::string& meshPath
+        const std::string& meshPath,
+        ThreadPool* threadPool = nullptr
+    );
+
+    struct Geometry;
+    Mesh(
+        const std::string& name,
+        Geometry geometry
     );
 
     const std::string getName()     const { return m_name; }
     const std::string getMeshPath() const { return m_meshPath; }
-
-    void update();
-    void draw();
-    void drawVertexNormals();
-    void drawFaceNormals();
+    bool isClosed()                 const { return m_isClosed; }
+    // Average vertex cache misses per triangle of the index buffer, simulated for a 16 entry FIFO
+    float getCacheMissRatio()       const { return m_cacheMissRatio; }
+
+    // Smooth normals are shared by every render vertex of a particle unless edges are hard, in
+    // which case vertices the loader split (for differing normals or UVs) are shaded apart
+    void setHardEdges(bool hardEdges);
+    bool hasHardEdges()             const { return m_hardEdges; }
+
+    // Refreshes render vertices and their area-weighted normals from the positions, spread over
+    // the pool for large meshes; the next draw streams them to the GPU
+    void update(ThreadPool* threadPool = nullptr);
+    void draw(RenderState& state);
+    // Normal lines of the render vertices and of the triangles, as last refreshed by update
+    void addVertexNormals(DebugDraw& debugDraw, uint32_t color) const;
+    void addFaceNormals(DebugDraw& debugDraw, uint32_t color) const;
     void destroy();
 
-    void setCandidateObjectMeshes(const std::vector<Object*>& objects);
-
     void constructDistanceConstraints();
     void constructVolumeConstraints(float& k);
-    void constructEnvCollisionConstraints();
 
 public:
     struct Vertex
@@ -47,6 +68,14 @@ public:
         glm::vec2 texCoords;
     };
 
+    // What the GPU receives each frame: position and a normal packed as GL_INT_2_10_10_10_REV,
+    // half the size of Vertex. Texture coordinates never change and sit in a buffer of their own.
+    struct StreamVertex
+    {
+        glm::vec3 position;
+        uint32_t normal;
+    };
+
     struct Edge
     {
         unsigned int v1;
@@ -60,8 +89,31 @@ public:
         unsigned int v3;
     };
 
+    struct Tetrahedron
+    {
+        unsigned int v1;
+        unsigned int v2;
+        unsigned int v3;
+        unsigned int v4;
+    };
+
+    // Loader output: welded particle positions plus the render vertices referencing them
+    struct Geometry
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> vertexToPositionIndex;
+        std::vector<unsigned int> indices;
+        std::vector<Tetrahedron> tetrahedra; // optional interior, adds distance constraints only
+    };
+
     std::vector<glm::vec3>& getPositions() { return m_positions; }
     const std::vector<Vertex>& getVertices() const { return m_vertices; }
+    const std::vector<unsigned int>& getIndices() const { return m_indices; }
+    const std::vector<StreamVertex>& getStreamVertices() const { return m_streamVertices; }
+    // Bumped by every update, so instanced batches can tell which members to re-stream
+    uint64_t getVertexVersion()              const { return m_vertexVersion; }
+    const MeshAdjacency& getAdjacency()      const { return *m_adjacency; }
 
     struct MouseDistanceConstraints
     {
@@ -87,31 +139,28 @@ public:
     };
     VolumeConstraints volumeConstraints;
 
+    // Surface particles tested against static geometry
     std::vector<unsigned int> envCollisionConstraintVertices;
-    struct EnvCollisionConstraints
-    {
-        std::vector<unsigned int> vertices;
-        const Mesh* candidateMesh;
-        std::vector<Constraint> C;
-        std::vector<ConstraintGradient> gradC;
-        std::map<unsigned int, std::vector<size_t>> vertexToConstraints; // TODO : size_t ???
-    };
-    std::vector<EnvCollisionConstraints> perEnvCollisionConstraints;
+    // Surface edges swept against static and other objects' edges
+    std::vector<Edge> envCollisionConstraintEdges;
 
 private:
-    void loadObjData(const std::string& meshPath);
+    void loadMeshData(const std::string& meshPath, ThreadPool* threadPool);
+    bool loadObjData(const std::string& meshPath, ThreadPool* threadPool);
+    void loadAssimpData(const std::string& meshPath);
+    void buildFromGeometry(Geometry geometry);
 
     void initVerticesBuffer();
+    void setStreamAttributes(unsigned int segment);
+    void packStreamVertices();
     void initNormalBuffers(GLuint& vao, GLuint& vbo, size_t numElements);
 
-    void constructVertices(const aiMesh* mesh);
-    void constructIndices(const aiMesh* mesh);
+    void constructVertices(const aiMesh* mesh, Geometry& geometry);
+    void constructIndices(const aiMesh* mesh, Geometry& geometry);
 
-    std::vector<glm::vec3> calculateFaceNormals();
-
-    void constructMouseDistanceConstraintVertices(const aiMesh* mesh);
-    void constructDistanceConstraintVertices(const aiMesh* mesh);
-    void constructVolumeConstraintVertices(const aiMesh* mesh);
+    void constructMouseDistanceConstraintVertices();
+    void constructDistanceConstraintVertices();
+    void constructVolumeConstraintVertices();
     void constructEnvCollisionConstraintVertices();
 
 private:
@@ -119,24 +168,26 @@ private:
     std::string m_meshPath;
 
     std::vector<glm::vec3> m_positions;
-    std::unordered_map<unsigned int, std::vector<unsigned int>> m_positionToVertexIndices;
     std::vector<unsigned int> m_vertexToPositionIndex;
-
-    GLuint m_VAO, m_VBO, m_EBO;
+    std::shared_ptr<const MeshAdjacency> m_adjacency; // topology is immutable, so copies share it
+
+    // Created on the first draw, so every copy of a mesh streams into buffers of its own
+    GLuint m_VAO = 0;
+    GLuint m_EBO = 0;
+    GLuint m_texCoordVBO = 0;
+    VertexStream m_vertexStream;
+    std::vector<StreamVertex> m_streamVertices;
+    unsigned int m_vertexSegment = 0;
+    bool m_verticesDirty = false;
+    uint64_t m_vertexVersion = 0;
     std::vector<Vertex> m_vertices;
     std::vector<unsigned int> m_indices;
+    std::vector<Tetrahedron> m_tetrahedra;
+    bool m_isClosed = false;
+    bool m_hardEdges = false;
+    float m_cacheMissRatio = 0.0f;
+    std::vector<glm::vec3> m_faceNormals; // unnormalised, twice the triangle area long
 
-    struct NormalLines
-    {
-        GLuint VAO = 0;
-        GLuint VBO = 0;
-        size_t vertexCount = 0;
-        size_t faceCount = 0;
-    };
-    NormalLines m_normalLines;
-    void initNormalBuffers();
     float m_vertexNormalLength;
     float m_faceNormalLength;
-
-    std::vector<const Mesh*> m_candidateObjectMeshes;
 };
\ No newline at end of file
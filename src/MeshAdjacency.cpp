@@ -0,0 +1,158 @@
+#include <algorithm>
+
+#include "MeshAdjacency.hpp"
+
+namespace
+{
+    constexpr unsigned int NO_TRIANGLE = ~0u;
+
+    uint64_t edgeKey(uint64_t a, uint64_t b)
+    {
+        return (std::min(a, b) << 32) | std::max(a, b);
+    }
+}
+
+MeshAdjacency::Csr MeshAdjacency::buildCsr(size_t numRows, const std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+{
+    Csr csr;
+    csr.offsets.assign(numRows + 1, 0);
+    for (const auto& [r, v] : pairs)
+    {
+        ++csr.offsets[r + 1];
+    }
+    for (size_t i = 0; i < numRows; ++i)
+    {
+        csr.offsets[i + 1] += csr.offsets[i];
+    }
+
+    csr.values.resize(pairs.size());
+    std::vector<unsigned int> cursor(csr.offsets.begin(), csr.offsets.end() - 1);
+    for (const auto& [r, v] : pairs)
+    {
+        csr.values[cursor[r]++] = v;
+    }
+    return csr;
+}
+
+MeshAdjacency::MeshAdjacency(
+    size_t numPositions,
+    const std::vector<unsigned int>& indices,
+    const std::vector<unsigned int>& vertexToPositionIndex,
+    const std::vector<Mesh::Tetrahedron>& tetrahedra
+)
+{
+    size_t numTriangles = indices.size() / 3;
+    m_triangles.reserve(numTriangles);
+    for (size_t t = 0; t < numTriangles; ++t)
+    {
+        m_triangles.push_back({
+            vertexToPositionIndex[indices[3 * t]],
+            vertexToPositionIndex[indices[3 * t + 1]],
+            vertexToPositionIndex[indices[3 * t + 2]]
+        });
+    }
+
+    // (edge key, owning triangle) records; sorting groups each edge's triangles together
+    std::vector<std::pair<uint64_t, unsigned int>> records;
+    records.reserve(numTriangles * 3 + tetrahedra.size() * 6);
+    for (unsigned int t = 0; t < numTriangles; ++t)
+    {
+        const auto& tri = m_triangles[t];
+        records.push_back({ edgeKey(tri.v1, tri.v2), t });
+        records.push_back({ edgeKey(tri.v2, tri.v3), t });
+        records.push_back({ edgeKey(tri.v3, tri.v1), t });
+    }
+    for (const auto& tet : tetrahedra)
+    {
+        const unsigned int v[4] = { tet.v1, tet.v2, tet.v3, tet.v4 };
+        for (int a = 0; a < 4; ++a)
+        {
+            for (int b = a + 1; b < 4; ++b)
+            {
+                records.push_back({ edgeKey(v[a], v[b]), NO_TRIANGLE });
+            }
+        }
+    }
+    std::sort(records.begin(), records.end());
+
+    std::vector<std::pair<unsigned int, unsigned int>> edgeTriangles;
+    edgeTriangles.reserve(numTriangles * 3);
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        uint64_t key = records[i].first;
+        if (i == 0 || key != records[i - 1].first)
+        {
+            m_edges.push_back({ static_cast<unsigned int>(key >> 32), static_cast<unsigned int>(key) });
+        }
+        if (records[i].second != NO_TRIANGLE)
+        {
+            edgeTriangles.push_back({ static_cast<unsigned int>(m_edges.size() - 1), records[i].second });
+        }
+    }
+    m_edgeTriangles = buildCsr(m_edges.size(), edgeTriangles);
+
+    std::vector<std::pair<unsigned int, unsigned int>> pairs;
+    pairs.reserve(m_edges.size() * 2);
+    for (unsigned int e = 0; e < m_edges.size(); ++e)
+    {
+        pairs.push_back({ m_edges[e].v1, e });
+        pairs.push_back({ m_edges[e].v2, e });
+    }
+    m_vertexEdges = buildCsr(numPositions, pairs);
+
+    pairs.clear();
+    for (unsigned int t = 0; t < numTriangles; ++t)
+    {
+        pairs.push_back({ m_triangles[t].v1, t });
+        pairs.push_back({ m_triangles[t].v2, t });
+        pairs.push_back({ m_triangles[t].v3, t });
+    }
+    m_vertexTriangles = buildCsr(numPositions, pairs);
+
+    pairs.clear();
+    for (unsigned int i = 0; i < vertexToPositionIndex.size(); ++i)
+    {
+        pairs.push_back({ vertexToPositionIndex[i], i });
+    }
+    m_positionVertices = buildCsr(numPositions, pairs);
+
+    pairs.clear();
+    for (unsigned int t = 0; t < numTriangles; ++t)
+    {
+        pairs.push_back({ indices[3 * t], t });
+        pairs.push_back({ indices[3 * t + 1], t });
+        pairs.push_back({ indices[3 * t + 2], t });
+    }
+    m_renderVertexTriangles = buildCsr(vertexToPositionIndex.size(), pairs);
+}
+
+unsigned int MeshAdjacency::findEdge(unsigned int a, unsigned int b) const
+{
+    unsigned int lo = std::min(a, b), hi = std::max(a, b);
+    for (unsigned int e : getVertexEdges(lo))
+    {
+        if (m_edges[e].v1 == lo && m_edges[e].v2 == hi)
+        {
+            return e;
+        }
+    }
+    return NO_EDGE;
+}
+
+bool MeshAdjacency::isClosed() const
+{
+    if (m_triangles.empty())
+    {
+        return false;
+    }
+
+    for (unsigned int e = 0; e < m_edges.size(); ++e)
+    {
+        size_t count = getEdgeTriangles(e).size();
+        if (count != 0 && count != 2)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "Mesh.hpp"
+
+// Immutable topology of a mesh in compressed sparse row form, built once per mesh and shared
+// by its copies. Vertex here means a welded particle (position index); render vertices are
+// only reachable through getPositionVertices. Triangle t is the t-th triangle of the index buffer.
+class MeshAdjacency
+{
+public:
+    MeshAdjacency() = default;
+    MeshAdjacency(
+        size_t numPositions,
+        const std::vector<unsigned int>& indices,
+        const std::vector<unsigned int>& vertexToPositionIndex,
+        const std::vector<Mesh::Tetrahedron>& tetrahedra
+    );
+
+    static constexpr unsigned int NO_EDGE = ~0u;
+
+    // Unique edges of the triangles and tetrahedra, (v1 < v2), sorted by v1 then v2
+    const std::vector<Mesh::Edge>& getEdges()         const { return m_edges; }
+    // Triangles as particle triples, in index buffer order
+    const std::vector<Mesh::Triangle>& getTriangles() const { return m_triangles; }
+
+    std::span<const unsigned int> getVertexEdges(unsigned int position)     const { return row(m_vertexEdges, position); }
+    std::span<const unsigned int> getVertexTriangles(unsigned int position) const { return row(m_vertexTriangles, position); }
+    std::span<const unsigned int> getEdgeTriangles(unsigned int edge)       const { return row(m_edgeTriangles, edge); }
+    std::span<const unsigned int> getPositionVertices(unsigned int position) const { return row(m_positionVertices, position); }
+    // Triangles using a render vertex; a subset of its particle's triangles where the loader split it
+    std::span<const unsigned int> getRenderVertexTriangles(unsigned int vertex) const { return row(m_renderVertexTriangles, vertex); }
+
+    // Index into getEdges(), or NO_EDGE
+    unsigned int findEdge(unsigned int a, unsigned int b) const;
+
+    // Every triangle edge is shared by exactly two triangles; tetrahedron-only edges are ignored
+    bool isClosed() const;
+
+private:
+    struct Csr
+    {
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> values;
+    };
+
+    static std::span<const unsigned int> row(const Csr& csr, unsigned int i)
+    {
+        return { csr.values.data() + csr.offsets[i], csr.values.data() + csr.offsets[i + 1] };
+    }
+
+    // Counting sort of (row, value) pairs; values keep their input order within a row
+    static Csr buildCsr(size_t numRows, const std::vector<std::pair<unsigned int, unsigned int>>& pairs);
+
+private:
+    std::vector<Mesh::Edge> m_edges;
+    std::vector<Mesh::Triangle> m_triangles;
+
+    Csr m_vertexEdges;
+    Csr m_vertexTriangles;
+    Csr m_edgeTriangles;
+    Csr m_positionVertices;
+    Csr m_renderVertexTriangles;
+};
@@ -0,0 +1,333 @@
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <glm/gtc/constants.hpp>
+
+#include "MeshGenerator.hpp"
+
+namespace
+{
+    glm::vec3 latticeToWorld(const glm::uvec3& lattice, const glm::uvec3& cells)
+    {
+        return -1.0f + 2.0f * glm::vec3(lattice) / glm::vec3(cells);
+    }
+
+    // Appends the six faces of a lattice spanning [-1, 1]^3 with outward CCW winding.
+    // Every face gets its own render vertices, positionIndex maps lattice points to welded positions.
+    template<typename PositionIndex>
+    void addLatticeSurface(Mesh::Geometry& geometry, const glm::uvec3& cells, PositionIndex positionIndex)
+    {
+        // (u, v) face axes with e_u × e_v = +e_axis
+        static constexpr int faceAxes[3][2] = { {1, 2}, {2, 0}, {0, 1} };
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                int u = faceAxes[axis][side ? 0 : 1];
+                int v = faceAxes[axis][side ? 1 : 0];
+
+                glm::vec3 normal(0.0f);
+                normal[axis] = side ? 1.0f : -1.0f;
+
+                unsigned int base = static_cast<unsigned int>(geometry.vertices.size());
+                for (unsigned int j = 0; j <= cells[v]; ++j)
+                {
+                    for (unsigned int i = 0; i <= cells[u]; ++i)
+                    {
+                        glm::uvec3 lattice;
+                        lattice[axis] = side ? cells[axis] : 0;
+                        lattice[u] = i;
+                        lattice[v] = j;
+
+                        unsigned int posIdx = positionIndex(lattice);
+
+                        Mesh::Vertex vertex;
+                        vertex.position = geometry.positions[posIdx];
+                        vertex.normal = normal;
+                        vertex.texCoords = glm::vec2(
+                            static_cast<float>(i) / static_cast<float>(cells[u]),
+                            static_cast<float>(j) / static_cast<float>(cells[v])
+                        );
+                        geometry.vertices.push_back(vertex);
+                        geometry.vertexToPositionIndex.push_back(posIdx);
+                    }
+                }
+
+                // Split quads along the min-to-max diagonal, matching the tetrahedra of tetBlock
+                unsigned int rowLength = cells[u] + 1;
+                for (unsigned int j = 0; j < cells[v]; ++j)
+                {
+                    for (unsigned int i = 0; i < cells[u]; ++i)
+                    {
+                        unsigned int c00 = base + j * rowLength + i;
+                        unsigned int c10 = c00 + 1;
+                        unsigned int c01 = c00 + rowLength;
+                        unsigned int c11 = c01 + 1;
+                        geometry.indices.insert(geometry.indices.end(), { c00, c10, c11, c00, c11, c01 });
+                    }
+                }
+            }
+        }
+    }
+
+    void requireResolution(const MeshGenerator::Config& config, size_t count, unsigned int minimum)
+    {
+        if (config.resolution.size() != count)
+        {
+            throw std::invalid_argument(
+                "'" + config.type + "' expects " + std::to_string(count) + " resolution value(s)"
+            );
+        }
+
+        for (unsigned int r : config.resolution)
+        {
+            if (r < minimum)
+            {
+                throw std::invalid_argument(
+                    "'" + config.type + "' resolution must be at least " + std::to_string(minimum)
+                );
+            }
+        }
+    }
+}
+
+namespace MeshGenerator
+{
+    std::string getName(const Config& config)
+    {
+        std::string name = config.type + "_";
+        for (size_t i = 0; i < config.resolution.size(); ++i)
+        {
+            if (i > 0) name += "x";
+            name += std::to_string(config.resolution[i]);
+        }
+        return name;
+    }
+
+    Mesh::Geometry generate(const Config& config)
+    {
+        const auto& r = config.resolution;
+        if (config.type == "clothGrid")
+        {
+            requireResolution(config, 2, 2);
+            return clothGrid(r[0], r[1]);
+        }
+        if (config.type == "icosphere")
+        {
+            requireResolution(config, 1, 0);
+            if (r[0] > 8)
+            {
+                throw std::invalid_argument("'icosphere' subdivisions must be at most 8");
+            }
+            return icosphere(r[0]);
+        }
+        if (config.type == "box")
+        {
+            requireResolution(config, 1, 1);
+            return box(r[0]);
+        }
+        if (config.type == "tetBlock")
+        {
+            requireResolution(config, 3, 1);
+            return tetBlock(r[0], r[1], r[2]);
+        }
+
+        throw std::invalid_argument("unknown mesh generator '" + config.type + "'");
+    }
+
+    Mesh::Geometry clothGrid(unsigned int resolutionX, unsigned int resolutionZ)
+    {
+        Mesh::Geometry geometry;
+        size_t numVertices = static_cast<size_t>(resolutionX) * resolutionZ;
+        geometry.positions.reserve(numVertices);
+        geometry.vertices.reserve(numVertices);
+        geometry.vertexToPositionIndex.reserve(numVertices);
+        geometry.indices.reserve(static_cast<size_t>(resolutionX - 1) * (resolutionZ - 1) * 6);
+
+        for (unsigned int j = 0; j < resolutionZ; ++j)
+        {
+            for (unsigned int i = 0; i < resolutionX; ++i)
+            {
+                glm::vec2 uv(
+                    static_cast<float>(i) / static_cast<float>(resolutionX - 1),
+                    static_cast<float>(j) / static_cast<float>(resolutionZ - 1)
+                );
+
+                Mesh::Vertex vertex;
+                vertex.position = glm::vec3(-2.0f + 4.0f * uv.x, 0.0f, -2.0f + 4.0f * uv.y);
+                vertex.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+                vertex.texCoords = uv;
+
+                geometry.vertexToPositionIndex.push_back(static_cast<unsigned int>(geometry.positions.size()));
+                geometry.positions.push_back(vertex.position);
+                geometry.vertices.push_back(vertex);
+            }
+        }
+
+        for (unsigned int j = 0; j + 1 < resolutionZ; ++j)
+        {
+            for (unsigned int i = 0; i + 1 < resolutionX; ++i)
+            {
+                unsigned int p00 = j * resolutionX + i;
+                unsigned int p10 = p00 + 1;
+                unsigned int p01 = p00 + resolutionX;
+                unsigned int p11 = p01 + 1;
+                geometry.indices.insert(geometry.indices.end(), { p00, p01, p11, p00, p11, p10 });
+            }
+        }
+
+        return geometry;
+    }
+
+    Mesh::Geometry icosphere(unsigned int subdivisions)
+    {
+        const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+
+        std::vector<glm::vec3> positions = {
+            {-1.0f,  t, 0.0f}, { 1.0f,  t, 0.0f}, {-1.0f, -t, 0.0f}, { 1.0f, -t, 0.0f},
+            { 0.0f, -1.0f,  t}, { 0.0f,  1.0f,  t}, { 0.0f, -1.0f, -t}, { 0.0f,  1.0f, -t},
+            {  t, 0.0f, -1.0f}, {  t, 0.0f,  1.0f}, { -t, 0.0f, -1.0f}, { -t, 0.0f,  1.0f}
+        };
+        for (auto& p : positions)
+        {
+            p = glm::normalize(p);
+        }
+
+        std::vector<unsigned int> indices = {
+            0, 11, 5,   0, 5, 1,    0, 1, 7,    0, 7, 10,   0, 10, 11,
+            1, 5, 9,    5, 11, 4,   11, 10, 2,  10, 7, 6,   7, 1, 8,
+            3, 9, 4,    3, 4, 2,    3, 2, 6,    3, 6, 8,    3, 8, 9,
+            4, 9, 5,    2, 4, 11,   6, 2, 10,   8, 6, 7,    9, 8, 1
+        };
+
+        for (unsigned int level = 0; level < subdivisions; ++level)
+        {
+            std::unordered_map<uint64_t, unsigned int> midpoints;
+            auto midpoint = [&](unsigned int a, unsigned int b) {
+                uint64_t key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                auto [it, inserted] = midpoints.try_emplace(key, static_cast<unsigned int>(positions.size()));
+                if (inserted)
+                {
+                    positions.push_back(glm::normalize(positions[a] + positions[b]));
+                }
+                return it->second;
+            };
+
+            std::vector<unsigned int> subdivided;
+            subdivided.reserve(indices.size() * 4);
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                unsigned int v1 = indices[i], v2 = indices[i + 1], v3 = indices[i + 2];
+                unsigned int a = midpoint(v1, v2);
+                unsigned int b = midpoint(v2, v3);
+                unsigned int c = midpoint(v3, v1);
+                subdivided.insert(subdivided.end(), { v1, a, c, v2, b, a, v3, c, b, a, b, c });
+            }
+            indices = std::move(subdivided);
+        }
+
+        Mesh::Geometry geometry;
+        geometry.vertices.reserve(positions.size());
+        for (unsigned int i = 0; i < positions.size(); ++i)
+        {
+            const glm::vec3& p = positions[i];
+
+            Mesh::Vertex vertex;
+            vertex.position = p;
+            vertex.normal = p;
+            vertex.texCoords = glm::vec2(
+                0.5f + std::atan2(p.z, p.x) / (2.0f * glm::pi<float>()),
+                std::acos(glm::clamp(p.y, -1.0f, 1.0f)) / glm::pi<float>()
+            );
+            geometry.vertices.push_back(vertex);
+            geometry.vertexToPositionIndex.push_back(i);
+        }
+        geometry.positions = std::move(positions);
+        geometry.indices = std::move(indices);
+
+        return geometry;
+    }
+
+    Mesh::Geometry box(unsigned int resolution)
+    {
+        Mesh::Geometry geometry;
+        glm::uvec3 cells(resolution);
+
+        // Only surface lattice points become particles, shared between adjacent faces
+        std::unordered_map<uint64_t, unsigned int> latticeToPosition;
+        addLatticeSurface(geometry, cells, [&](const glm::uvec3& lattice) {
+            uint64_t key = (static_cast<uint64_t>(lattice.x) << 42)
+                         | (static_cast<uint64_t>(lattice.y) << 21)
+                         | lattice.z;
+            auto [it, inserted] = latticeToPosition.try_emplace(key, static_cast<unsigned int>(geometry.positions.size()));
+            if (inserted)
+            {
+                geometry.positions.push_back(latticeToWorld(lattice, cells));
+            }
+            return it->second;
+        });
+
+        return geometry;
+    }
+
+    Mesh::Geometry tetBlock(unsigned int resolutionX, unsigned int resolutionY, unsigned int resolutionZ)
+    {
+        Mesh::Geometry geometry;
+        glm::uvec3 cells(resolutionX, resolutionY, resolutionZ);
+        glm::uvec3 points = cells + 1u;
+
+        auto latticeIndex = [&](const glm::uvec3& lattice) {
+            return lattice.x + points.x * (lattice.y + points.y * lattice.z);
+        };
+
+        // Interior lattice points are particles too, without render vertices
+        geometry.positions.reserve(static_cast<size_t>(points.x) * points.y * points.z);
+        for (unsigned int z = 0; z < points.z; ++z)
+        {
+            for (unsigned int y = 0; y < points.y; ++y)
+            {
+                for (unsigned int x = 0; x < points.x; ++x)
+                {
+                    geometry.positions.push_back(latticeToWorld(glm::uvec3(x, y, z), cells));
+                }
+            }
+        }
+
+        // Kuhn subdivision: six tetrahedra per cell along its main diagonal, conforming across cells
+        static constexpr std::array<std::array<int, 3>, 6> axisOrders = {{
+            {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}
+        }};
+
+        geometry.tetrahedra.reserve(static_cast<size_t>(cells.x) * cells.y * cells.z * 6);
+        for (unsigned int z = 0; z < cells.z; ++z)
+        {
+            for (unsigned int y = 0; y < cells.y; ++y)
+            {
+                for (unsigned int x = 0; x < cells.x; ++x)
+                {
+                    glm::uvec3 origin(x, y, z);
+                    for (const auto& order : axisOrders)
+                    {
+                        glm::uvec3 c1 = origin;
+                        c1[order[0]] += 1;
+                        glm::uvec3 c2 = c1;
+                        c2[order[1]] += 1;
+
+                        Mesh::Tetrahedron tetrahedron;
+                        tetrahedron.v1 = latticeIndex(origin);
+                        tetrahedron.v2 = latticeIndex(c1);
+                        tetrahedron.v3 = latticeIndex(c2);
+                        tetrahedron.v4 = latticeIndex(origin + 1u);
+                        geometry.tetrahedra.push_back(tetrahedron);
+                    }
+                }
+            }
+        }
+
+        addLatticeSurface(geometry, cells, latticeIndex);
+
+        return geometry;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Mesh.hpp"
+
+namespace MeshGenerator
+{
+    struct Config
+    {
+        std::string type;
+        std::vector<unsigned int> resolution;
+    };
+
+    // Resource name identifying a generator configuration, e.g. "clothGrid_64x64"
+    std::string getName(const Config& config);
+
+    // Dispatches on config.type; throws std::invalid_argument for unknown types or bad resolutions
+    Mesh::Geometry generate(const Config& config);
+
+    // Flat cloth on the XZ plane spanning [-2, 2], with resolutionX × resolutionZ vertices
+    Mesh::Geometry clothGrid(unsigned int resolutionX, unsigned int resolutionZ);
+
+    // Unit icosphere, each subdivision level quadruples the triangle count
+    Mesh::Geometry icosphere(unsigned int subdivisions);
+
+    // Box spanning [-1, 1]^3 with resolution × resolution quads per face
+    Mesh::Geometry box(unsigned int resolution);
+
+    // Box spanning [-1, 1]^3 filled with tetrahedra, six per lattice cell
+    Mesh::Geometry tetBlock(unsigned int resolutionX, unsigned int resolutionY, unsigned int resolutionZ);
+}
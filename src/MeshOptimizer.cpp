@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "MeshOptimizer.hpp"
+#include "MeshAdjacency.hpp"
+
+namespace
+{
+    // Symmetric particle adjacency in compressed sparse row form
+    struct Adjacency
+    {
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> neighbours;
+
+        unsigned int degree(unsigned int v) const { return offsets[v + 1] - offsets[v]; }
+    };
+
+    Adjacency buildAdjacency(const MeshAdjacency& meshAdjacency, size_t numPositions)
+    {
+        const auto& edges = meshAdjacency.getEdges();
+        Adjacency adjacency;
+        adjacency.offsets.assign(numPositions + 1, 0);
+        adjacency.neighbours.reserve(edges.size() * 2);
+        for (unsigned int v = 0; v < numPositions; ++v)
+        {
+            for (unsigned int e : meshAdjacency.getVertexEdges(v))
+            {
+                adjacency.neighbours.push_back(edges[e].v1 == v ? edges[e].v2 : edges[e].v1);
+            }
+            adjacency.offsets[v + 1] = static_cast<unsigned int>(adjacency.neighbours.size());
+        }
+        return adjacency;
+    }
+
+    unsigned int bandwidth(const std::vector<Mesh::Edge>& edges, const std::vector<unsigned int>& newIndex)
+    {
+        unsigned int result = 0;
+        for (const auto& edge : edges)
+        {
+            unsigned int a = newIndex[edge.v1];
+            unsigned int b = newIndex[edge.v2];
+            result = std::max(result, a > b ? a - b : b - a);
+        }
+        return result;
+    }
+
+    // Breadth-first sweep over the unvisited part of start's component, children in ascending degree
+    void cuthillMcKeeSweep(
+        const Adjacency& adjacency,
+        unsigned int start,
+        std::vector<unsigned int>& stamp,
+        unsigned int currentStamp,
+        std::vector<unsigned int>& order
+    )
+    {
+        size_t head = order.size();
+        order.push_back(start);
+        stamp[start] = currentStamp;
+
+        std::vector<unsigned int> children;
+        while (head < order.size())
+        {
+            unsigned int v = order[head++];
+            children.clear();
+            for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+            {
+                unsigned int u = adjacency.neighbours[i];
+                if (stamp[u] != currentStamp)
+                {
+                    stamp[u] = currentStamp;
+                    children.push_back(u);
+                }
+            }
+            std::sort(children.begin(), children.end(), [&adjacency](unsigned int a, unsigned int b) {
+                return adjacency.degree(a) < adjacency.degree(b);
+            });
+            order.insert(order.end(), children.begin(), children.end());
+        }
+    }
+
+    // George-Liu heuristic: restart from a low-degree vertex of the deepest level until the depth stops growing
+    unsigned int findPseudoPeripheral(
+        const Adjacency& adjacency,
+        unsigned int start,
+        std::vector<unsigned int>& stamp,
+        unsigned int& currentStamp,
+        const std::vector<unsigned int>& visitedStamp
+    )
+    {
+        std::vector<unsigned int> queue, level;
+        size_t bestDepth = 0;
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+            ++currentStamp;
+            queue.assign(1, start);
+            level.assign(1, 0);
+            stamp[start] = currentStamp;
+            for (size_t head = 0; head < queue.size(); ++head)
+            {
+                unsigned int v = queue[head];
+                for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+                {
+                    unsigned int u = adjacency.neighbours[i];
+                    if (stamp[u] != currentStamp && visitedStamp[u] == 0)
+                    {
+                        stamp[u] = currentStamp;
+                        queue.push_back(u);
+                        level.push_back(level[head] + 1);
+                    }
+                }
+            }
+
+            size_t depth = level.back();
+            if (iteration > 0 && depth <= bestDepth) break;
+            bestDepth = depth;
+
+            unsigned int candidate = queue.back();
+            for (size_t i = queue.size(); i-- > 0 && level[i] == depth; )
+            {
+                if (adjacency.degree(queue[i]) < adjacency.degree(candidate)) candidate = queue[i];
+            }
+            if (candidate == start) break;
+            start = candidate;
+        }
+        return start;
+    }
+
+    std::vector<unsigned int> reverseCuthillMcKee(const Adjacency& adjacency, size_t numPositions)
+    {
+        std::vector<unsigned int> byDegree(numPositions);
+        std::iota(byDegree.begin(), byDegree.end(), 0u);
+        std::stable_sort(byDegree.begin(), byDegree.end(), [&adjacency](unsigned int a, unsigned int b) {
+            return adjacency.degree(a) < adjacency.degree(b);
+        });
+
+        std::vector<unsigned int> order;
+        order.reserve(numPositions);
+        std::vector<unsigned int> visited(numPositions, 0);
+        std::vector<unsigned int> stamp(numPositions, 0);
+        unsigned int currentStamp = 0;
+
+        for (unsigned int seed : byDegree)
+        {
+            if (visited[seed]) continue;
+
+            unsigned int start = findPseudoPeripheral(adjacency, seed, stamp, currentStamp, visited);
+            size_t first = order.size();
+            cuthillMcKeeSweep(adjacency, start, visited, 1, order);
+            std::reverse(order.begin() + first, order.end());
+        }
+
+        return order;
+    }
+
+    void remapPositions(Mesh::Geometry& geometry, const std::vector<unsigned int>& newIndex)
+    {
+        std::vector<glm::vec3> positions(geometry.positions.size());
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            positions[newIndex[i]] = geometry.positions[i];
+        }
+        geometry.positions = std::move(positions);
+
+        for (auto& p : geometry.vertexToPositionIndex)
+        {
+            p = newIndex[p];
+        }
+
+        for (auto& tet : geometry.tetrahedra)
+        {
+            tet = { newIndex[tet.v1], newIndex[tet.v2], newIndex[tet.v3], newIndex[tet.v4] };
+        }
+    }
+
+    // Forsyth's scoring: recently used vertices score high, except the last triangle's three, which
+    // would rarely be reused by the very next one, and vertices with few triangles left get a boost
+    // so they are finished off instead of lingering as isolated leftovers
+    constexpr unsigned int FORSYTH_CACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    float vertexScore(int cachePosition, unsigned int remainingTriangles)
+    {
+        if (remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else
+            {
+                const float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+            }
+        }
+        return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+    }
+
+    std::vector<unsigned int> forsythTriangleOrder(const std::vector<unsigned int>& indices, size_t numVertices)
+    {
+        const size_t numTriangles = indices.size() / 3;
+
+        // Triangles of each vertex in compressed sparse row form; the first remaining[v] entries are
+        // the ones not yet emitted
+        std::vector<unsigned int> offsets(numVertices + 1, 0);
+        for (unsigned int index : indices) ++offsets[index + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<unsigned int> vertexTriangles(indices.size());
+        std::vector<unsigned int> remaining(numVertices, 0);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            const unsigned int v = indices[i];
+            vertexTriangles[offsets[v] + remaining[v]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        std::vector<float> scores(numVertices);
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            scores[v] = vertexScore(-1, remaining[v]);
+        }
+
+        auto triangleScore = [&indices, &scores](unsigned int t) {
+            return scores[indices[3 * t]] + scores[indices[3 * t + 1]] + scores[indices[3 * t + 2]];
+        };
+
+        std::vector<bool> emitted(numTriangles, false);
+
+        std::vector<unsigned int> order;
+        order.reserve(numTriangles);
+        std::vector<unsigned int> cache, nextCache;
+        cache.reserve(FORSYTH_CACHE_SIZE + 3);
+        nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+        size_t cursor = 0;
+        size_t best = numTriangles;
+        float bestScore = -1.0f;
+        for (unsigned int t = 0; t < numTriangles; ++t)
+        {
+            const float score = triangleScore(t);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = t;
+            }
+        }
+
+        while (order.size() < numTriangles)
+        {
+            // Nothing in the cache touches an unemitted triangle: start over from the next one in input order
+            if (best == numTriangles)
+            {
+                while (emitted[cursor]) ++cursor;
+                best = cursor;
+            }
+
+            const unsigned int triangle = static_cast<unsigned int>(best);
+            emitted[triangle] = true;
+            order.push_back(triangle);
+
+            nextCache.clear();
+            for (int j = 0; j < 3; ++j)
+            {
+                const unsigned int v = indices[3 * triangle + j];
+                nextCache.push_back(v);
+
+                // Move the triangle past the vertex's remaining ones
+                unsigned int* first = vertexTriangles.data() + offsets[v];
+                unsigned int* last = first + remaining[v];
+                std::iter_swap(std::find(first, last, triangle), last - 1);
+                --remaining[v];
+            }
+            for (unsigned int v : cache)
+            {
+                if (v != nextCache[0] && v != nextCache[1] && v != nextCache[2]) nextCache.push_back(v);
+            }
+
+            // Evicted vertices lose their cache score; everything still cached is rescored by its new slot
+            for (size_t i = FORSYTH_CACHE_SIZE; i < nextCache.size(); ++i)
+            {
+                const unsigned int v = nextCache[i];
+                scores[v] = vertexScore(-1, remaining[v]);
+            }
+            if (nextCache.size() > FORSYTH_CACHE_SIZE) nextCache.resize(FORSYTH_CACHE_SIZE);
+            for (size_t i = 0; i < nextCache.size(); ++i)
+            {
+                const unsigned int v = nextCache[i];
+                scores[v] = vertexScore(static_cast<int>(i), remaining[v]);
+            }
+            std::swap(cache, nextCache);
+
+            // Only triangles of cached vertices changed score, so the next pick is among them
+            best = numTriangles;
+            bestScore = -1.0f;
+            for (unsigned int v : cache)
+            {
+                for (unsigned int k = offsets[v]; k < offsets[v] + remaining[v]; ++k)
+                {
+                    const unsigned int t = vertexTriangles[k];
+                    const float score = triangleScore(t);
+                    if (score > bestScore)
+                    {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+        }
+
+        return order;
+    }
+
+    // Vertices are renumbered by first use, so fetches walk the vertex buffer front to back;
+    // unreferenced vertices keep their relative order at the end
+    void sortVerticesByFirstUse(Mesh::Geometry& geometry)
+    {
+        const size_t numVertices = geometry.vertices.size();
+        constexpr unsigned int UNASSIGNED = ~0u;
+        std::vector<unsigned int> newVertexIndex(numVertices, UNASSIGNED);
+        unsigned int next = 0;
+        for (unsigned int index : geometry.indices)
+        {
+            if (newVertexIndex[index] == UNASSIGNED) newVertexIndex[index] = next++;
+        }
+        for (auto& index : newVertexIndex)
+        {
+            if (index == UNASSIGNED) index = next++;
+        }
+
+        std::vector<Mesh::Vertex> vertices(numVertices);
+        std::vector<unsigned int> vertexToPositionIndex(numVertices);
+        for (size_t i = 0; i < numVertices; ++i)
+        {
+            vertices[newVertexIndex[i]] = geometry.vertices[i];
+            vertexToPositionIndex[newVertexIndex[i]] = geometry.vertexToPositionIndex[i];
+        }
+        geometry.vertices = std::move(vertices);
+        geometry.vertexToPositionIndex = std::move(vertexToPositionIndex);
+
+        for (auto& index : geometry.indices)
+        {
+            index = newVertexIndex[index];
+        }
+    }
+
+    void sortTetrahedra(Mesh::Geometry& geometry)
+    {
+        for (auto& tet : geometry.tetrahedra)
+        {
+            // Even permutations only, so the orientation is kept
+            unsigned int lowest = std::min({ tet.v1, tet.v2, tet.v3, tet.v4 });
+            if (tet.v2 == lowest)      tet = { tet.v2, tet.v1, tet.v4, tet.v3 };
+            else if (tet.v3 == lowest) tet = { tet.v3, tet.v4, tet.v1, tet.v2 };
+            else if (tet.v4 == lowest) tet = { tet.v4, tet.v3, tet.v2, tet.v1 };
+        }
+
+        std::stable_sort(geometry.tetrahedra.begin(), geometry.tetrahedra.end(), [](const auto& a, const auto& b) {
+            return a.v1 < b.v1;
+        });
+    }
+}
+
+namespace MeshOptimizer
+{
+    std::pair<unsigned int, unsigned int> reorderForLocality(Mesh::Geometry& geometry)
+    {
+        size_t numPositions = geometry.positions.size();
+
+        MeshAdjacency meshAdjacency(numPositions, geometry.indices, geometry.vertexToPositionIndex, geometry.tetrahedra);
+        const auto& edges = meshAdjacency.getEdges();
+        Adjacency adjacency = buildAdjacency(meshAdjacency, numPositions);
+
+        std::vector<unsigned int> identity(numPositions);
+        std::iota(identity.begin(), identity.end(), 0u);
+        unsigned int bandwidthBefore = bandwidth(edges, identity);
+
+        std::vector<unsigned int> order = reverseCuthillMcKee(adjacency, numPositions);
+        std::vector<unsigned int> newIndex(numPositions);
+        for (size_t i = 0; i < numPositions; ++i)
+        {
+            newIndex[order[i]] = static_cast<unsigned int>(i);
+        }
+        unsigned int bandwidthAfter = bandwidth(edges, newIndex);
+
+        remapPositions(geometry, newIndex);
+        sortTetrahedra(geometry);
+
+        return { bandwidthBefore, bandwidthAfter };
+    }
+
+    std::pair<float, float> optimizeVertexCache(Mesh::Geometry& geometry)
+    {
+        const size_t numVertices = geometry.vertices.size();
+        const float missRatioBefore = averageCacheMissRatio(geometry.indices, numVertices);
+
+        std::vector<unsigned int> order = forsythTriangleOrder(geometry.indices, numVertices);
+        std::vector<unsigned int> indices(geometry.indices.size());
+        for (size_t t = 0; t < order.size(); ++t)
+        {
+            std::copy_n(geometry.indices.begin() + 3 * order[t], 3, indices.begin() + 3 * t);
+        }
+        geometry.indices = std::move(indices);
+        sortVerticesByFirstUse(geometry);
+
+        return { missRatioBefore, averageCacheMissRatio(geometry.indices, numVertices) };
+    }
+
+    float averageCacheMissRatio(const std::vector<unsigned int>& indices, size_t numVertices, unsigned int cacheSize)
+    {
+        const size_t numTriangles = indices.size() / 3;
+        if (numTriangles == 0) return 0.0f;
+
+        // A vertex is cached while fewer than cacheSize misses have happened since it was loaded
+        constexpr size_t NEVER_LOADED = ~size_t(0);
+        std::vector<size_t> loadedAt(numVertices, NEVER_LOADED);
+        size_t misses = 0;
+        for (unsigned int index : indices)
+        {
+            if (loadedAt[index] == NEVER_LOADED || misses - loadedAt[index] >= cacheSize)
+            {
+                loadedAt[index] = misses++;
+            }
+        }
+        return static_cast<float>(misses) / numTriangles;
+    }
+}
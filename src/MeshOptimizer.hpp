@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Mesh.hpp"
+
+namespace MeshOptimizer
+{
+    // Post-transform cache size assumed when reporting miss ratios
+    static constexpr unsigned int SIMULATED_CACHE_SIZE = 16;
+
+    // Renumbers the welded particles in reverse Cuthill-McKee order over the edge graph, so
+    // constraint neighbours sit close together in memory. Tetrahedra are rotated to start at
+    // their lowest particle and sorted by it, keeping their orientation.
+    // Returns the particle bandwidth (largest index gap across an edge) before and after.
+    std::pair<unsigned int, unsigned int> reorderForLocality(Mesh::Geometry& geometry);
+
+    // Reorders triangles for the post-transform vertex cache (Forsyth's linear-speed heuristic),
+    // then renumbers render vertices in the order the triangles first use them so vertex fetches
+    // stream. Winding is preserved.
+    // Returns the average cache miss ratio (misses per triangle) before and after.
+    std::pair<float, float> optimizeVertexCache(Mesh::Geometry& geometry);
+
+    // Misses per triangle of a FIFO cache of cacheSize vertices over the index buffer
+    float averageCacheMissRatio(const std::vector<unsigned int>& indices, size_t numVertices, unsigned int cacheSize = SIMULATED_CACHE_SIZE);
+}
@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ObjParser.hpp"
+#include "PositionWelder.hpp"
+
+namespace
+{
+    constexpr int NO_INDEX = std::numeric_limits<int>::min();
+    constexpr unsigned int UNASSIGNED = std::numeric_limits<unsigned int>::max();
+    constexpr size_t MIN_CHUNK_SIZE = 1 << 16;
+
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& filePath)
+        {
+            int fd = open(filePath.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("cannot open file");
+            }
+
+            struct stat fileStat;
+            if (fstat(fd, &fileStat) != 0)
+            {
+                close(fd);
+                throw std::runtime_error("cannot stat file");
+            }
+
+            m_size = static_cast<size_t>(fileStat.st_size);
+            if (m_size > 0)
+            {
+                void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED)
+                {
+                    close(fd);
+                    throw std::runtime_error("cannot map file");
+                }
+                madvise(data, m_size, MADV_WILLNEED);
+                m_data = static_cast<const char*>(data);
+            }
+            close(fd);
+        }
+
+        ~MappedFile()
+        {
+            if (m_data)
+            {
+                munmap(const_cast<char*>(m_data), m_size);
+            }
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* begin() const { return m_data; }
+        const char* end()   const { return m_data + m_size; }
+        size_t size()       const { return m_size; }
+
+    private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    enum RelativeIndex : unsigned char
+    {
+        RELATIVE_V  = 1 << 0,
+        RELATIVE_VT = 1 << 1,
+        RELATIVE_VN = 1 << 2
+    };
+
+    struct Corner
+    {
+        int v;
+        int vt;
+        int vn;
+        unsigned char relative; // indices still relative to the chunk start
+    };
+
+    struct Chunk
+    {
+        const char* begin;
+        const char* end;
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        std::vector<Corner> corners; // three per triangle
+
+        size_t positionBase = 0;
+        size_t texCoordBase = 0;
+        size_t normalBase = 0;
+        size_t cornerBase = 0;
+
+        std::string error;
+    };
+
+    inline bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    inline const char* skipBlanks(const char* p, const char* end)
+    {
+        while (p < end && isBlank(*p)) ++p;
+        return p;
+    }
+
+    inline const char* parseFloat(const char* p, const char* end, float& value)
+    {
+        p = skipBlanks(p, end);
+        if (p < end && *p == '+') ++p;
+
+        auto [ptr, ec] = std::from_chars(p, end, value);
+        if (ec != std::errc())
+        {
+            value = 0.0f;
+        }
+        return ptr;
+    }
+
+    // OBJ indices are 1-based, negative ones count back from the latest element
+    inline int resolveIndex(int index, size_t localCount, unsigned char flag, unsigned char& relative)
+    {
+        if (index > 0)
+        {
+            return index - 1;
+        }
+
+        relative |= flag;
+        return static_cast<int>(localCount) + index;
+    }
+
+    const char* parseCorner(const char* p, const char* end, const Chunk& chunk, Corner& corner)
+    {
+        int indices[3] = { 0, 0, 0 };
+        for (int k = 0; k < 3; ++k)
+        {
+            if (k > 0)
+            {
+                if (p >= end || *p != '/') break;
+                ++p;
+            }
+
+            auto [ptr, ec] = std::from_chars(p, end, indices[k]);
+            if (ec == std::errc())
+            {
+                p = ptr;
+            }
+        }
+
+        if (indices[0] == 0)
+        {
+            return nullptr;
+        }
+
+        corner.relative = 0;
+        corner.v  = resolveIndex(indices[0], chunk.positions.size(), RELATIVE_V, corner.relative);
+        corner.vt = indices[1] ? resolveIndex(indices[1], chunk.texCoords.size(), RELATIVE_VT, corner.relative) : NO_INDEX;
+        corner.vn = indices[2] ? resolveIndex(indices[2], chunk.normals.size(), RELATIVE_VN, corner.relative) : NO_INDEX;
+        return p;
+    }
+
+    // Polygons are fan-triangulated, matching aiProcess_Triangulate
+    void parseFace(const char* p, const char* lineEnd, Chunk& chunk)
+    {
+        Corner first{}, previous{}, current{};
+        int count = 0;
+        while (true)
+        {
+            p = skipBlanks(p, lineEnd);
+            if (p >= lineEnd || *p == '\r' || *p == '#') break;
+
+            p = parseCorner(p, lineEnd, chunk, current);
+            if (!p)
+            {
+                throw std::runtime_error("malformed face record");
+            }
+
+            if (count == 0)
+            {
+                first = current;
+            }
+            else if (count >= 2)
+            {
+                chunk.corners.push_back(first);
+                chunk.corners.push_back(previous);
+                chunk.corners.push_back(current);
+            }
+
+            previous = current;
+            ++count;
+        }
+    }
+
+    void parseChunk(Chunk& chunk)
+    {
+        const char* p = chunk.begin;
+        const char* end = chunk.end;
+
+        while (p < end)
+        {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!lineEnd) lineEnd = end;
+
+            p = skipBlanks(p, lineEnd);
+            size_t length = lineEnd - p;
+
+            if (length >= 2 && p[0] == 'v' && isBlank(p[1]))
+            {
+                glm::vec3 position;
+                const char* q = parseFloat(p + 2, lineEnd, position.x);
+                q = parseFloat(q, lineEnd, position.y);
+                parseFloat(q, lineEnd, position.z);
+                chunk.positions.push_back(position);
+            }
+            else if (length >= 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2]))
+            {
+                glm::vec2 texCoord;
+                const char* q = parseFloat(p + 3, lineEnd, texCoord.x);
+                parseFloat(q, lineEnd, texCoord.y);
+                chunk.texCoords.push_back(texCoord);
+            }
+            else if (length >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2]))
+            {
+                glm::vec3 normal;
+                const char* q = parseFloat(p + 3, lineEnd, normal.x);
+                q = parseFloat(q, lineEnd, normal.y);
+                parseFloat(q, lineEnd, normal.z);
+                chunk.normals.push_back(normal);
+            }
+            else if (length >= 2 && p[0] == 'f' && isBlank(p[1]))
+            {
+                parseFace(p + 2, lineEnd, chunk);
+            }
+
+            p = lineEnd + 1;
+        }
+    }
+
+    std::vector<Chunk> splitIntoChunks(const char* begin, const char* end, size_t numChunks)
+    {
+        std::vector<Chunk> chunks;
+        chunks.reserve(numChunks);
+
+        size_t size = end - begin;
+        const char* chunkBegin = begin;
+        for (size_t i = 1; i <= numChunks && chunkBegin < end; ++i)
+        {
+            const char* chunkEnd = (i == numChunks) ? end : std::max(chunkBegin, begin + size * i / numChunks);
+
+            // Move the split point past the end of the current line
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+
+            Chunk chunk;
+            chunk.begin = chunkBegin;
+            chunk.end = chunkEnd;
+            chunks.push_back(std::move(chunk));
+            chunkBegin = chunkEnd;
+        }
+
+        return chunks;
+    }
+
+    // A failing chunk records its error instead of throwing: parallel_for would rethrow while other
+    // chunks still read the mapped file and write the shared buffers, and parse would free them
+    template<typename Func>
+    void forEachChunk(std::vector<Chunk>& chunks, ThreadPool* threadPool, Func func)
+    {
+        auto guarded = [&func](Chunk& chunk) {
+            try
+            {
+                func(chunk);
+            }
+            catch (const std::exception& e)
+            {
+                chunk.error = e.what();
+            }
+        };
+
+        if (threadPool && chunks.size() > 1)
+        {
+            threadPool->parallel_for(chunks, guarded);
+        }
+        else
+        {
+            for (auto& chunk : chunks)
+            {
+                guarded(chunk);
+            }
+        }
+
+        for (const auto& chunk : chunks)
+        {
+            if (!chunk.error.empty())
+            {
+                throw std::runtime_error(chunk.error);
+            }
+        }
+    }
+
+    // Area-weighted smooth normals, equivalent to aiProcess_GenSmoothNormals
+    void generateMissingNormals(Mesh::Geometry& geometry, const std::vector<bool>& missingNormal)
+    {
+        std::vector<glm::vec3> positionNormals(geometry.positions.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < geometry.indices.size(); i += 3)
+        {
+            unsigned int p0 = geometry.vertexToPositionIndex[geometry.indices[i]];
+            unsigned int p1 = geometry.vertexToPositionIndex[geometry.indices[i + 1]];
+            unsigned int p2 = geometry.vertexToPositionIndex[geometry.indices[i + 2]];
+
+            const glm::vec3& x0 = geometry.positions[p0];
+            glm::vec3 faceNormal = glm::cross(geometry.positions[p1] - x0, geometry.positions[p2] - x0);
+            positionNormals[p0] += faceNormal;
+            positionNormals[p1] += faceNormal;
+            positionNormals[p2] += faceNormal;
+        }
+
+        for (size_t i = 0; i < geometry.vertices.size(); ++i)
+        {
+            if (!missingNormal[i]) continue;
+
+            const glm::vec3& n = positionNormals[geometry.vertexToPositionIndex[i]];
+            float length = glm::length(n);
+            geometry.vertices[i].normal = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+}
+
+namespace ObjParser
+{
+    Mesh::Geometry parse(const std::string& filePath, ThreadPool* threadPool)
+    {
+        MappedFile file(filePath);
+
+        size_t numChunks = 1;
+        if (threadPool)
+        {
+            numChunks = std::clamp<size_t>(file.size() / MIN_CHUNK_SIZE, 1, threadPool->getThreadCount());
+        }
+
+        std::vector<Chunk> chunks = splitIntoChunks(file.begin(), file.end(), numChunks);
+        forEachChunk(chunks, threadPool, [](Chunk& chunk) { parseChunk(chunk); });
+
+        // Global offsets of every chunk's records
+        size_t numPositions = 0, numTexCoords = 0, numNormals = 0, numCorners = 0;
+        for (auto& chunk : chunks)
+        {
+            chunk.positionBase = numPositions;
+            chunk.texCoordBase = numTexCoords;
+            chunk.normalBase = numNormals;
+            chunk.cornerBase = numCorners;
+            numPositions += chunk.positions.size();
+            numTexCoords += chunk.texCoords.size();
+            numNormals += chunk.normals.size();
+            numCorners += chunk.corners.size();
+        }
+
+        if (numCorners == 0)
+        {
+            throw std::runtime_error("no faces found");
+        }
+
+        std::vector<glm::vec3> positions(numPositions);
+        std::vector<glm::vec2> texCoords(numTexCoords);
+        std::vector<glm::vec3> normals(numNormals);
+        std::vector<Corner> corners(numCorners);
+
+        forEachChunk(chunks, threadPool, [&](Chunk& chunk) {
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionBase);
+            std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + chunk.texCoordBase);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalBase);
+
+            for (size_t i = 0; i < chunk.corners.size(); ++i)
+            {
+                Corner corner = chunk.corners[i];
+                if (corner.relative & RELATIVE_V)  corner.v  += static_cast<int>(chunk.positionBase);
+                if (corner.relative & RELATIVE_VT) corner.vt += static_cast<int>(chunk.texCoordBase);
+                if (corner.relative & RELATIVE_VN) corner.vn += static_cast<int>(chunk.normalBase);
+
+                bool valid = corner.v >= 0 && static_cast<size_t>(corner.v) < numPositions
+                    && (corner.vt == NO_INDEX || (corner.vt >= 0 && static_cast<size_t>(corner.vt) < numTexCoords))
+                    && (corner.vn == NO_INDEX || (corner.vn >= 0 && static_cast<size_t>(corner.vn) < numNormals));
+                if (!valid)
+                {
+                    throw std::runtime_error("face index out of range");
+                }
+
+                corners[chunk.cornerBase + i] = corner;
+            }
+
+            chunk.positions = {};
+            chunk.texCoords = {};
+            chunk.normals = {};
+            chunk.corners = {};
+        });
+
+        // Render vertices are unique (v, vt, vn) triples, chained per OBJ position
+        Mesh::Geometry geometry;
+        PositionWelder welder(geometry.positions, numPositions);
+
+        std::vector<unsigned int> positionToWelded(numPositions, UNASSIGNED);
+        std::vector<int> firstVertex(numPositions, -1);
+        std::vector<int> nextVertex;
+        std::vector<Corner> vertexKeys;
+        std::vector<bool> missingNormal;
+
+        geometry.indices.reserve(numCorners);
+        for (const Corner& corner : corners)
+        {
+            int vertexIdx = firstVertex[corner.v];
+            while (vertexIdx >= 0 && (vertexKeys[vertexIdx].vt != corner.vt || vertexKeys[vertexIdx].vn != corner.vn))
+            {
+                vertexIdx = nextVertex[vertexIdx];
+            }
+
+            if (vertexIdx < 0)
+            {
+                vertexIdx = static_cast<int>(geometry.vertices.size());
+                nextVertex.push_back(firstVertex[corner.v]);
+                firstVertex[corner.v] = vertexIdx;
+                vertexKeys.push_back(corner);
+
+                if (positionToWelded[corner.v] == UNASSIGNED)
+                {
+                    positionToWelded[corner.v] = welder.weld(positions[corner.v]);
+                }
+
+                Mesh::Vertex vertex;
+                vertex.position = positions[corner.v];
+                vertex.texCoords = glm::vec2(0.0f, 0.0f);
+                if (corner.vt != NO_INDEX)
+                {
+                    // Flip V like aiProcess_FlipUVs
+                    const glm::vec2& texCoord = texCoords[corner.vt];
+                    vertex.texCoords = glm::vec2(texCoord.x, 1.0f - texCoord.y);
+                }
+                vertex.normal = corner.vn != NO_INDEX ? normals[corner.vn] : glm::vec3(0.0f);
+
+                geometry.vertices.push_back(vertex);
+                geometry.vertexToPositionIndex.push_back(positionToWelded[corner.v]);
+                missingNormal.push_back(corner.vn == NO_INDEX);
+            }
+
+            geometry.indices.push_back(static_cast<unsigned int>(vertexIdx));
+        }
+
+        if (std::find(missingNormal.begin(), missingNormal.end(), true) != missingNormal.end())
+        {
+            generateMissingNormals(geometry, missingNormal);
+        }
+
+        return geometry;
+    }
+}
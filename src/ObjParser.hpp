@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+#include "Mesh.hpp"
+#include "ThreadPool.hpp"
+
+namespace ObjParser
+{
+    // Memory-maps a Wavefront OBJ file and parses its v/vt/vn/f records in
+    // line-aligned chunks on the given pool (serially when no pool is given).
+    // Positions come out welded and render vertices are unique (v, vt, vn) triples.
+    // Throws std::runtime_error when the file cannot be read or holds no faces.
+    Mesh::Geometry parse(const std::string& filePath, ThreadPool* threadPool = nullptr);
+}
@@ -1,7 +1,17 @@
 #include "glm/fwd.hpp"
 #include "logger.hpp"
+#include "MeshAdjacency.hpp"
 #include "Object.hpp"
 
+namespace {
+    const uint32_t VERTEX_NORMAL_COLOR = DebugDraw::packColor(glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    const uint32_t FACE_NORMAL_COLOR = DebugDraw::packColor(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    const uint32_t BOUNDS_COLOR = DebugDraw::packColor(glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
+    const uint32_t BVH_NODE_COLOR = DebugDraw::packColor(glm::vec4(0.0f, 0.8f, 0.8f, 1.0f));
+    const uint32_t BVH_LEAF_COLOR = DebugDraw::packColor(glm::vec4(0.2f, 0.4f, 1.0f, 1.0f));
+    constexpr float MAX_DISPLAYED_STRAIN = 0.1f;
+}
+
 Object::Object(
     std::string name,
     Transform transform,
@@ -20,8 +30,8 @@ Object::Object(
       m_color(color),
       m_isStatic(isStatic),
       m_polygonMode(GL_FILL),
-      m_enablevertexNormalShader(false),
-      m_enableFaceNormalShader(false)
+      m_showVertexNormals(false),
+      m_showFaceNormals(false)
 {
 
     std::vector<glm::vec3>& positions = m_mesh.getPositions();
@@ -55,31 +65,48 @@ Object::Object(
         // create distance constraints
         m_mesh.constructDistanceConstraints();
 
-        // create volume constraints
-        m_mesh.constructVolumeConstraints(k);
+        // create volume constraints, only meaningful for closed surfaces
+        if (m_mesh.isClosed()) {
+            m_mesh.constructVolumeConstraints(k);
+        }
     }
 
+    // Static objects only move if made kinematic later, so their vertices are placed once here
+    m_mesh.update();
+    updateTransformWithCOM();
+
     logger::info("  - Created '{}' object successfully", name);
 }
 
 Object::~Object() {
+    m_mesh.destroy();
     logger::info("  - Destroyed '{}' object successfully", m_name);
 }
 
 void Object::updateTransformWithCOM() {
     glm::vec3 centerOfMass = glm::vec3(0.0f);
+    Aabb bounds;
     auto& positions = m_mesh.getPositions();
     for (const auto& pos : positions) {
         centerOfMass += pos;
+        bounds.expand(pos);
     }
     centerOfMass /= static_cast<float>(positions.size());
     m_transform.setPosition(centerOfMass);
+    m_bounds = bounds;
 }
 
 void Object::update(
-    float deltaTime
+    float deltaTime,
+    const Frustum& frustum,
+    ThreadPool* threadPool
 )
 {
+    if (m_isStatic && !isKinematic()) {
+        m_visible = frustum.intersects(m_bounds);
+        return;
+    }
+
     auto& positions = m_mesh.getPositions();
     auto& vertexTransforms = m_vertexTransforms;
     size_t n = positions.size();
@@ -88,8 +115,13 @@ void Object::update(
         positions[i] = vertexTransforms[i].getPosition();
     }
 
-    m_mesh.update();
     updateTransformWithCOM();
+
+    // Render vertices and normals are only read for drawing, so hidden objects leave them stale
+    m_visible = frustum.intersects(m_bounds);
+    if (m_visible) {
+        m_mesh.update(threadPool);
+    }
 }
 
 void Object::resetVertexTransforms() {
@@ -102,69 +134,161 @@ void Object::resetVertexTransforms() {
         m_vertexTransforms[i].setPosition(initialVertexTransforms[i].getPosition());
         m_vertexTransforms[i].setVelocity(initialVertexTransforms[i].getVelocity());
     }
+    m_animationTime = 0.0f;
 
     m_mesh.update();
+    updateTransformWithCOM();
+}
+
+void Object::makeKinematic(KinematicAnimation animation) {
+    if (!m_isStatic || animation.empty()) {
+        return;
+    }
+
+    KinematicAnimation::Pose start = animation.sample(0.0f);
+    glm::quat inverseRotation = glm::inverse(start.rotation);
+    m_kinematicPositions.clear();
+    m_kinematicPositions.reserve(m_vertexTransforms.size());
+    for (const auto& vertexTransform : m_vertexTransforms) {
+        m_kinematicPositions.push_back(inverseRotation * (vertexTransform.getPosition() - start.position));
+    }
+
+    m_animation = std::move(animation);
+    m_animationTime = 0.0f;
+    logger::info("  - Made '{}' kinematic", m_name);
+}
+
+void Object::advanceKinematic(float deltaTime) {
+    if (!m_animation) {
+        return;
+    }
+
+    m_animationTime += deltaTime;
+    KinematicAnimation::Pose pose = m_animation->sample(m_animationTime);
+    for (size_t i = 0; i < m_vertexTransforms.size(); ++i) {
+        glm::vec3 position = pose.rotation * m_kinematicPositions[i] + pose.position;
+        if (deltaTime > 0.0f) {
+            m_vertexTransforms[i].setVelocity((position - m_vertexTransforms[i].getPosition()) / deltaTime);
+        }
+        m_vertexTransforms[i].setPosition(position);
+    }
 }
 
-void Object::setProjectionViewUniforms(
-    const Shader& shader
+void Object::enableSelfCollision() {
+    const auto& edges = m_mesh.distanceConstraints.edges;
+    if (m_isStatic || edges.empty()) {
+        return;
+    }
+
+    // Half the mean edge length keeps particles one ring apart from touching at rest
+    const auto& positions = m_mesh.getPositions();
+    float totalLength = 0.0f;
+    for (const auto& edge : edges) {
+        totalLength += glm::distance(positions[edge.v1], positions[edge.v2]);
+    }
+    float thickness = 0.5f * totalLength / static_cast<float>(edges.size());
+
+    m_selfCollider.emplace(m_mesh, thickness);
+    logger::info("  - Enabled self-collision for '{}' with thickness {}", m_name, thickness);
+}
+
+void Object::refitTriangleBvh(
+    const std::vector<glm::vec3>& p,
+    const std::vector<glm::vec3>& x,
+    float margin
 )
 {
-    int projectionLoc = glGetUniformLocation(shader.getID(), "projection");
-    glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, glm::value_ptr(m_transform.getProjectionMatrix()));
+    const auto& triangles = m_mesh.getAdjacency().getTriangles();
+    m_triangleBounds.assign(triangles.size(), Aabb{});
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        for (unsigned int v : { triangles[t].v1, triangles[t].v2, triangles[t].v3 }) {
+            m_triangleBounds[t].expand(p[v]);
+            m_triangleBounds[t].expand(x[v]);
+        }
+        m_triangleBounds[t].inflate(margin);
+    }
 
-    int viewLoc = glGetUniformLocation(shader.getID(), "view");
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(m_transform.getViewMatrix()));
+    // Topology never changes, so the tree from the first call is refitted from then on
+    if (m_triangleBvh.size() != triangles.size()) {
+        m_triangleBvh.build(m_triangleBounds);
+    } else {
+        m_triangleBvh.refit(m_triangleBounds);
+    }
 }
 
-void Object::render(
-    Light* light,
-    const glm::vec3& cameraPosition,
-    float barrierSize
+void Object::submit(
+    RenderQueue& queue
 )
 {
-    glPolygonMode(GL_FRONT_AND_BACK, m_polygonMode);
-    glLineWidth(3.0f);
+    if (!m_visible) return;
+
+    // Untextured until the background decode finishes. Uploads happen here, before the queue
+    // binds anything, so they can't disturb the cached texture binding.
+    GLuint texture = m_texture && m_texture->makeResident() ? m_texture->getID() : 0;
 
-    m_shader.useProgram();
-    m_shader.setVec3("objectColor", m_color);
-    m_shader.setVec3("lightColor", light->getColor());
-    m_shader.setVec3("lightPos", light->getPosition());
-    m_shader.setVec3("viewPos", cameraPosition);
+    // Only closed surfaces are culled; cloth and other open sheets show both sides
+    bool cullFace = m_polygonMode == GL_FILL && m_mesh.isClosed();
+    queue.add({ m_shader.getID(), texture, m_polygonMode, cullFace, 3.0f }, this);
+}
+
+void Object::draw(
+    const RenderQueue::Item& item,
+    RenderState& state,
+    float barrierSize
+)
+{
+    // Camera and light come from the frame uniform block; only per-object values are set here
+    state.setUniform(m_shader, "objectColor", m_color);
 
     if (m_name == "Ground") {
-        m_shader.setFloat("barrierSize", barrierSize);
+        state.setUniform(m_shader, "barrierSize", barrierSize);
     }
 
-    if (m_texture) {
-        m_texture->bind();
-        m_shader.setInt("ourTexture", 0); // 0 for single texture
-        m_shader.setInt("hasTexture", 1);
-    } else {
-        m_shader.setInt("hasTexture", 0);
+    // The sampler stays on unit 0
+    if (item.drawState.texture) {
+        state.bindTexture(item.drawState.texture);
     }
+    state.setUniform(m_shader, "hasTexture", item.drawState.texture ? 1 : 0);
 
-    setProjectionViewUniforms(m_shader);
-    m_mesh.draw();
+    m_mesh.draw(state);
+}
 
-    glLineWidth(1.0f);
+void Object::addDebugGeometry(
+    DebugDraw& debugDraw,
+    const DebugDraw::Options& options
+) const
+{
+    if (!m_visible) return;
 
-    if (m_polygonMode != GL_LINE) {
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+    if (m_showVertexNormals) {
+        m_mesh.addVertexNormals(debugDraw, VERTEX_NORMAL_COLOR);
+    }
+    if (m_showFaceNormals) {
+        m_mesh.addFaceNormals(debugDraw, FACE_NORMAL_COLOR);
     }
 
-    if (m_enableFaceNormalShader) {
-        s_faceNormalShader.useProgram();
-        setProjectionViewUniforms(s_faceNormalShader);
-        m_mesh.drawFaceNormals();
+    if (options.bounds) {
+        debugDraw.addBox(m_bounds, BOUNDS_COLOR);
     }
 
-    if (m_enablevertexNormalShader) {
-        s_vertexNormalShader.useProgram();
-        setProjectionViewUniforms(s_vertexNormalShader);
-        m_mesh.drawVertexNormals();
+    if (options.bvh) {
+        m_triangleBvh.forEachNode([&](const Aabb& bounds, bool isLeaf) {
+            debugDraw.addBox(bounds, isLeaf ? BVH_LEAF_COLOR : BVH_NODE_COLOR);
+        });
     }
 
-    glDisable(GL_CULL_FACE);
-}
\ No newline at end of file
+    // Edges blue when compressed, white at rest length and red when stretched
+    if (options.constraintStrain && !m_isStatic) {
+        for (const auto& edge : m_mesh.distanceConstraints.edges) {
+            glm::vec3 x1 = m_vertexTransforms[edge.v1].getPosition();
+            glm::vec3 x2 = m_vertexTransforms[edge.v2].getPosition();
+            float restLength = glm::distance(m_initialVertexTransforms[edge.v1].getPosition(), m_initialVertexTransforms[edge.v2].getPosition());
+            float strain = restLength > 0.0f ? (glm::distance(x1, x2) - restLength) / restLength : 0.0f;
+            float t = glm::clamp(strain / MAX_DISPLAYED_STRAIN, -1.0f, 1.0f);
+            glm::vec3 color = t >= 0.0f
+                ? glm::mix(glm::vec3(1.0f), glm::vec3(1.0f, 0.0f, 0.0f), t)
+                : glm::mix(glm::vec3(1.0f), glm::vec3(0.0f, 0.0f, 1.0f), -t);
+            debugDraw.addLine(x1, x2, DebugDraw::packColor(glm::vec4(color, 1.0f)));
+        }
+    }
+}
@@ -13,6 +13,12 @@
 #include "Mesh.hpp"
 #include "Light.hpp"
 #include "Texture.hpp"
+#include "SelfCollider.hpp"
+#include "Bvh.hpp"
+#include "DebugDraw.hpp"
+#include "Frustum.hpp"
+#include "KinematicAnimation.hpp"
+#include "RenderQueue.hpp"
 
 class Object {
 public:
@@ -32,9 +38,19 @@ public:
     std::string getName() const { return m_name; }
     const glm::vec3& getColor() const { return m_color; }
 
-    void update(float deltaTime);
+    // Objects outside the frustum keep their particles and bounds current but skip the render
+    // mesh refresh, its upload and the draw until they come back into view
+    void update(float deltaTime, const Frustum& frustum, ThreadPool* threadPool = nullptr);
+    // Center of mass and bounds, in one pass over the positions
     void updateTransformWithCOM();
-    void render(Light* light, const glm::vec3& cameraPosition, float barrierSize);
+    const Aabb& getBounds() const { return m_bounds; }
+    bool isVisible()        const { return m_visible; }
+    // Queues the surface and any enabled normal lines with the state each needs
+    void submit(RenderQueue& queue);
+    // Draws one queued item; the queue has already applied its program, polygon mode and culling
+    void draw(const RenderQueue::Item& item, RenderState& state, float barrierSize);
+    // Normals and the enabled overlays, skipped while out of view
+    void addDebugGeometry(DebugDraw& debugDraw, const DebugDraw::Options& options) const;
 
     void setPolygonMode(GLenum mode) { m_polygonMode = mode; }
     GLenum getPolygonMode() const { return m_polygonMode; }
@@ -44,6 +60,7 @@ public:
     Transform& getTransform() { return m_transform; }
     std::vector<Transform>& getVertexTransforms() { return m_vertexTransforms; }
     Mesh& getMesh() { return m_mesh; }
+    const Mesh& getMesh() const { return m_mesh; }
     const std::vector<float>& getMass() const { return m_M; }
 
     float getDistanceConstraintEnergy() const { return m_distanceEnergy; }
@@ -54,31 +71,43 @@ public:
 
     void resetVertexTransforms();
 
-    void setProjectionViewUniforms(const Shader& shader);
-
-    bool getEnableVertexNormalShader() const { return m_enablevertexNormalShader; }
-    void setEnableVertexNormalShader(bool enable) { m_enablevertexNormalShader = enable; }
+    // Kinematic objects stay static to the solver but follow their animation. The object must have
+    // been placed at the animation's first pose, which its positions are re-posed from every frame.
+    void makeKinematic(KinematicAnimation animation);
+    bool isKinematic() const { return m_animation.has_value(); }
+    void advanceKinematic(float deltaTime);
+
+    // Thickness is derived from the rest edge lengths, so it scales with mesh resolution
+    void enableSelfCollision();
+    SelfCollider* getSelfCollider() { return m_selfCollider ? &*m_selfCollider : nullptr; }
+
+    // One tree over the surface triangles, shared by picking and object collision. Built on the
+    // first refit; each box covers its triangle from p to x, inflated by margin.
+    void refitTriangleBvh(
+        const std::vector<glm::vec3>& p,
+        const std::vector<glm::vec3>& x,
+        float margin
+    );
+    const Bvh& getTriangleBvh() const { return m_triangleBvh; }
 
-    bool getEnableFaceNormalShader() const { return m_enableFaceNormalShader; }
-    void setEnableFaceNormalShader(bool enable) { m_enableFaceNormalShader = enable; }
+    bool getShowVertexNormals() const { return m_showVertexNormals; }
+    void setShowVertexNormals(bool show) { m_showVertexNormals = show; }
 
-    static void setVertexNormalShader(const Shader& shader) { s_vertexNormalShader = shader; }
-    static void setFaceNormalShader(const Shader& shader)   { s_faceNormalShader   = shader; }
+    bool getShowFaceNormals() const { return m_showFaceNormals; }
+    void setShowFaceNormals(bool show) { m_showFaceNormals = show; }
 
 private:
     std::string m_name;
     Transform m_transform;
     Shader m_shader;
-    static Shader s_vertexNormalShader;
-    static Shader s_faceNormalShader;
     Mesh m_mesh;
     std::optional<Texture> m_texture;
     glm::vec3 m_color;
     bool m_isStatic;
     GLenum m_polygonMode;
 
-    bool m_enablevertexNormalShader;
-    bool m_enableFaceNormalShader;
+    bool m_showVertexNormals;
+    bool m_showFaceNormals;
 
     std::vector<Transform> m_initialVertexTransforms;
     std::vector<Transform> m_vertexTransforms;
@@ -89,4 +118,16 @@ private:
 
     std::vector<bool> m_pinnedVertices;
 
+    std::optional<SelfCollider> m_selfCollider;
+
+    std::optional<KinematicAnimation> m_animation;
+    float m_animationTime = 0.0f;
+    std::vector<glm::vec3> m_kinematicPositions; // relative to the first pose
+
+    Bvh m_triangleBvh;
+    std::vector<Aabb> m_triangleBounds;
+
+    Aabb m_bounds;
+    bool m_visible = true;
+
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "PhysicsEngine.hpp"
 
 const std::string RESOURCE_PATH = "../res/";
+const std::string CACHE_PATH = "../cache/";
 
 
 std::unique_ptr<ShaderManager> PhysicsEngine::loadShaders() {
@@ -34,7 +35,7 @@ std::unique_ptr<MeshManager> PhysicsEngine::loadMeshes() {
     for (const auto& [name, filename] : MESH_DATA) {
         std::string meshPath = std::string(RESOURCE_PATH) + "meshes/" + std::string(filename);
         try {
-            meshes.push_back(std::make_unique<Mesh>(std::string(name).c_str(), meshPath.c_str()));
+            meshes.push_back(std::make_unique<Mesh>(std::string(name).c_str(), meshPath.c_str(), m_resourcePool.get()));
             logger::info("  - Loaded '{}' mesh successfully", name);
         } catch (const std::exception& e) {
             logger::error("Failed to load mesh '{}' : {}", name, e.what());
@@ -47,47 +48,36 @@ std::unique_ptr<MeshManager> PhysicsEngine::loadMeshes() {
 }
 
 std::unique_ptr<TextureManager> PhysicsEngine::loadTextures() {
-    logger::info(" - Loading textures...");
+    // Decoding is deferred until a scene requests the texture
+    logger::info(" - Registering textures...");
     auto textureManager = std::make_unique<TextureManager>();
     std::vector<std::unique_ptr<Texture>> textures;
 
     for (const auto& [name, filename] : TEXTURE_DATA) {
         std::string texturePath = std::string(RESOURCE_PATH) + "textures/" + std::string(filename);
         try {
-            textures.push_back(std::make_unique<Texture>(std::string(name).c_str(), texturePath.c_str()));
-            logger::info("  - Loaded '{}' texture successfully", name);
+            textures.push_back(std::make_unique<Texture>(std::string(name), texturePath, CACHE_PATH + "textures/", m_resourcePool.get()));
+            logger::info("  - Registered '{}' texture successfully", name);
         } catch (const std::exception& e) {
             logger::error("- Failed to load texture '{}' : {}", name, e.what());
         }
     }
 
-    logger::info(" - Loaded textures successfully");
+    logger::info(" - Registered textures successfully");
     textureManager->addResources(std::move(textures));
     return textureManager;
 }
 
 void PhysicsEngine::loadResources() {
     logger::info("Loading resources...");
+    m_resourcePool = std::make_unique<ThreadPool>();
     m_shaderManager = loadShaders();
     m_meshManager = loadMeshes();
     m_textureManager = loadTextures();
     logger::info("Loaded resources successfully");
 }
 
-PhysicsEngine::PhysicsEngine(
-    const char* engineName,
-    const unsigned int screenWidth,
-    const unsigned int screenHeight
-)
-    : m_engineName(engineName),
-      m_screenWidth(screenWidth),
-      m_screenHeight(screenHeight),
-      m_targetFPS(60.0f)
-{
-    logger::debug("--- Running in DEBUG mode ---");
-    logger::info("Initializing: {}", engineName);
-
-    // init GLFW window
+void PhysicsEngine::createWindow() {
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -95,12 +85,66 @@ PhysicsEngine::PhysicsEngine(
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
     glfwWindowHint(GLFW_MAXIMIZED, GLFW_FALSE);
 
-    m_window = glfwCreateWindow(screenWidth, screenHeight, engineName, NULL, NULL);
+    m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_engineName, NULL, NULL);
     if(!m_window)
     {
         glfwTerminate();
         throw std::runtime_error("Failed to create GLFW window");
     }
+}
+
+void PhysicsEngine::createHeadlessContext() {
+    // GLFW 3.4's null platform needs no display; its context comes from surfaceless EGL or, failing
+    // that, OSMesa, both of which Mesa provides on top of llvmpipe
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+    if (!glfwInit()) {
+        throw std::runtime_error("Failed to initialize GLFW for headless rendering");
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+    for (int contextApi : { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API }) {
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+        m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_engineName, NULL, NULL);
+        if (m_window) break;
+    }
+#else
+    // Older GLFW can only hide a regular window, which still needs a display
+    m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_engineName, NULL, NULL);
+#endif
+    if (!m_window) {
+        glfwTerminate();
+        throw std::runtime_error("Failed to create headless OpenGL context");
+    }
+}
+
+PhysicsEngine::PhysicsEngine(
+    const char* engineName,
+    const unsigned int screenWidth,
+    const unsigned int screenHeight,
+    std::optional<HeadlessConfig> headless
+)
+    : m_engineName(engineName),
+      m_screenWidth(screenWidth),
+      m_screenHeight(screenHeight),
+      m_targetFPS(60.0f),
+      m_headless(std::move(headless))
+{
+    logger::debug("--- Running in DEBUG mode ---");
+    logger::info("Initializing: {}", engineName);
+
+    if (m_headless) {
+        createHeadlessContext();
+    }
+    else {
+        createWindow();
+    }
 
     glfwMakeContextCurrent(m_window);
 
@@ -110,7 +154,7 @@ PhysicsEngine::PhysicsEngine(
         throw std::runtime_error("Failed to load GLAD");
     }
 
-    logger::info("GLFW window created");
+    logger::info(m_headless ? "Headless OpenGL context created" : "GLFW window created");
 
 
     // create timer
@@ -120,9 +164,14 @@ PhysicsEngine::PhysicsEngine(
     framebufferSizeCallback(m_window, screenWidth, screenHeight);
     glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
 
-    // create debug window
-    const char* glslVersion = "#version 330";
-    m_debugWindow = std::make_unique<DebugWindow>(m_window, glslVersion);
+    // create debug window, or the offscreen target that replaces the window's framebuffer
+    if (m_headless) {
+        m_frameCapture = std::make_unique<FrameCapture>(screenWidth, screenHeight, m_headless->outputDirectory);
+    }
+    else {
+        const char* glslVersion = "#version 330";
+        m_debugWindow = std::make_unique<DebugWindow>(m_window, glslVersion);
+    }
 
     // load resources
     loadResources();
@@ -139,12 +188,25 @@ PhysicsEngine::PhysicsEngine(
 
     // create and select first scene
     m_sceneManager->createScenes();
-    m_sceneManager->switchScene(std::string(SCENE_LIST[0].first));
+    if (m_headless && !m_headless->sceneName.empty()) {
+        m_sceneManager->switchScene(m_headless->sceneName);
+    }
+    else {
+        m_sceneManager->switchScene(std::string(SCENE_LIST[0].first));
+    }
 };
 
 PhysicsEngine::~PhysicsEngine() {}
 
 void PhysicsEngine::handleEvents() {
+    if (m_headless) {
+        if (m_framesRendered >= m_headless->frameCount) {
+            m_isRunning = false;
+            logger::info("Rendered {} headless frames, closing {}...", m_framesRendered, m_engineName);
+        }
+        return;
+    }
+
     if (glfwWindowShouldClose(m_window)) {
         m_isRunning = false;
         logger::info("Closing {}...", m_engineName);
@@ -179,9 +241,9 @@ void PhysicsEngine::processInput() {
     );
     glm::vec3 cameraPos = camera->getPosition();
 
-    auto pick = scene->pickObject(cameraPos, rayDir);
+    // Picking only happens on the press itself; hovering costs nothing
     if (mouseState == GLFW_PRESS && !mouseWasPressed) {
-        scene->createMouseConstraints(pick);
+        scene->createMouseConstraints(scene->pickObject(cameraPos, rayDir));
         mouseWasPressed = true;
     }
     else if (mouseState == GLFW_PRESS && mouseWasPressed) {
@@ -194,16 +256,27 @@ void PhysicsEngine::processInput() {
 }
 
 void PhysicsEngine::update() {
-    processInput();
+    if (m_headless && m_framesRendered == 0) {
+        m_headlessStart = std::chrono::steady_clock::now();
+    }
+    if (!m_headless) {
+        processInput();
+    }
     m_timer->startFrame();
 
+    // Headless runs step a fixed time so every run renders the same frames
     Scene* currentScene = m_sceneManager->getCurrentScene();
     if (currentScene) {
-        currentScene->update(m_timer->getDeltaTime());
+        currentScene->update(m_headless ? m_headless->timeStep : m_timer->getDeltaTime());
     }
 }
 
 void PhysicsEngine::render() {
+    if (m_headless) {
+        renderHeadless();
+        return;
+    }
+
     Scene* currentScene = m_sceneManager->getCurrentScene();
     if (currentScene) {
         currentScene->render();
@@ -218,8 +291,38 @@ void PhysicsEngine::render() {
     m_timer->capFrameRate(m_targetFPS);
 }
 
+void PhysicsEngine::renderHeadless() {
+    m_frameCapture->bind();
+
+    Scene* currentScene = m_sceneManager->getCurrentScene();
+    if (currentScene) {
+        currentScene->render();
+    }
+
+    m_frameCapture->capture();
+    ++m_framesRendered;
+}
+
 void PhysicsEngine::close() {
-    m_debugWindow->close();
+    if (m_frameCapture) {
+        // Throughput includes readback and writing, since the last frames are only done once written
+        m_frameCapture->finish();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_headlessStart
+        ).count();
+        const long long framesPerSecond = elapsed > 0 ? 1000LL * m_framesRendered / elapsed : 0;
+        logger::info(
+            "Headless throughput: {} frames in {} ms ({} frames/s)",
+            m_framesRendered,
+            static_cast<long long>(elapsed),
+            framesPerSecond
+        );
+        m_frameCapture.reset();
+    }
+
+    if (m_debugWindow) {
+        m_debugWindow->close();
+    }
     m_sceneManager->clearScenes();
 
     glfwTerminate();
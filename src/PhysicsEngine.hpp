@@ -1,12 +1,26 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <string>
 #include <glad.h>
 #include <GLFW/glfw3.h>
 
+#include "FrameCapture.hpp"
 #include "ImGuiWindow.hpp"
 #include "SceneManager.hpp"
 #include "Timer.hpp"
+#include "ThreadPool.hpp"
+
+// Runs without a window or debug UI, rendering offscreen at a fixed time step for a set number of frames
+struct HeadlessConfig
+{
+    unsigned int frameCount = 600;
+    float timeStep = 1.0f / 60.0f;
+    std::string outputDirectory; // frames are written here as PPM images; none are written if empty
+    std::string sceneName;       // first scene if empty
+};
 
 class PhysicsEngine
 {
@@ -14,7 +28,8 @@ public:
     PhysicsEngine(
         const char* engineName,
         const unsigned int screenWidth,
-        const unsigned int screenHeight
+        const unsigned int screenHeight,
+        std::optional<HeadlessConfig> headless = std::nullopt
     );
     ~PhysicsEngine();
 
@@ -34,12 +49,16 @@ public:
 private:
     static void framebufferSizeCallback(GLFWwindow* window, int width, int height) { glViewport(0, 0, width, height); }
 
+    void createWindow();
+    void createHeadlessContext();
+
     void loadResources();
     std::unique_ptr<ShaderManager> loadShaders();
     std::unique_ptr<MeshManager> loadMeshes();
     std::unique_ptr<TextureManager> loadTextures();
 
     void processInput();
+    void renderHeadless();
 
 private:
     const char* m_engineName;
@@ -48,6 +67,7 @@ private:
     const unsigned int m_screenHeight;
     GLFWwindow* m_window = nullptr;
 
+    std::unique_ptr<ThreadPool> m_resourcePool;
     std::unique_ptr<ShaderManager> m_shaderManager;
     std::unique_ptr<MeshManager> m_meshManager;
     std::unique_ptr<TextureManager> m_textureManager;
@@ -57,4 +77,9 @@ private:
     std::unique_ptr<Timer> m_timer;
 
     std::unique_ptr<DebugWindow> m_debugWindow;
+
+    std::optional<HeadlessConfig> m_headless;
+    std::unique_ptr<FrameCapture> m_frameCapture;
+    unsigned int m_framesRendered = 0;
+    std::chrono::steady_clock::time_point m_headlessStart;
 };
\ No newline at end of file
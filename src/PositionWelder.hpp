@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Open-addressing table welding bit-identical positions, appending each new one to positions.
+// The table never grows, so expectedCount must bound the number of distinct positions.
+class PositionWelder
+{
+public:
+    PositionWelder(std::vector<glm::vec3>& positions, size_t expectedCount)
+        : m_positions(positions)
+    {
+        size_t capacity = 16;
+        while (capacity < expectedCount * 2) capacity <<= 1;
+        m_slots.assign(capacity, EMPTY_SLOT);
+    }
+
+    unsigned int weld(const glm::vec3& position)
+    {
+        // +0.0f folds negative zero so it welds with positive zero
+        glm::vec3 key = position + glm::vec3(0.0f);
+        uint32_t bits[3];
+        std::memcpy(bits, &key, sizeof(bits));
+
+        // Float bit patterns have mostly-zero low bits, so mix well before masking
+        uint64_t hash = (static_cast<uint64_t>(bits[0]) << 32 | bits[1]) ^ (static_cast<uint64_t>(bits[2]) * 0x9E3779B97F4A7C15ull);
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+
+        size_t mask = m_slots.size() - 1;
+        size_t slot = static_cast<size_t>(hash) & mask;
+        while (m_slots[slot] != EMPTY_SLOT)
+        {
+            if (m_positions[m_slots[slot]] == key)
+            {
+                return m_slots[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        unsigned int index = static_cast<unsigned int>(m_positions.size());
+        m_positions.push_back(key);
+        m_slots[slot] = index;
+        return index;
+    }
+
+private:
+    std::vector<glm::vec3>& m_positions;
+    std::vector<unsigned int> m_slots;
+
+    static constexpr unsigned int EMPTY_SLOT = std::numeric_limits<unsigned int>::max();
+};
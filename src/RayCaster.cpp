@@ -0,0 +1,82 @@
+#include <algorithm>
+
+#include "RayCaster.hpp"
+#include "RayPacket.hpp"
+#include "MeshAdjacency.hpp"
+#include "Object.hpp"
+
+void RayCaster::prepare(const std::vector<Object*>& objects)
+{
+    m_targets.resize(objects.size());
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        Target& target = m_targets[i];
+        target.object = objects[i];
+
+        const auto& vertexTransforms = target.object->getVertexTransforms();
+        target.positions.resize(vertexTransforms.size());
+        for (size_t v = 0; v < vertexTransforms.size(); ++v)
+        {
+            target.positions[v] = vertexTransforms[v].getPosition();
+        }
+        target.object->refitTriangleBvh(target.positions, target.positions, 0.0f);
+    }
+}
+
+void RayCaster::cast(std::span<const Ray> rays, std::span<RayHit> hits, ThreadPool* pool) const
+{
+    const size_t packetCount = (rays.size() + RayPacket::SIZE - 1) / RayPacket::SIZE;
+    auto castPackets = [this, rays, hits](size_t begin, size_t end) {
+        for (size_t packet = begin; packet < end; ++packet)
+        {
+            const size_t first = packet * RayPacket::SIZE;
+            const size_t count = std::min<size_t>(RayPacket::SIZE, rays.size() - first);
+            castPacket(rays.subspan(first, count), hits.subspan(first, count));
+        }
+    };
+
+    if (pool)
+    {
+        pool->parallel_for_range(packetCount, castPackets);
+    }
+    else
+    {
+        castPackets(0, packetCount);
+    }
+}
+
+void RayCaster::castPacket(std::span<const Ray> rays, std::span<RayHit> hits) const
+{
+    RayPacket packet;
+    for (unsigned int lane = 0; lane < rays.size(); ++lane)
+    {
+        const Ray& ray = rays[lane];
+        packet.setRay(lane, ray.origin, glm::normalize(ray.direction), ray.maxDistance);
+    }
+
+    for (unsigned int t = 0; t < m_targets.size(); ++t)
+    {
+        const Target& target = m_targets[t];
+        const auto& triangles = target.object->getMesh().getAdjacency().getTriangles();
+        const auto& x = target.positions;
+        target.object->getTriangleBvh().queryRayPacket(packet, [&](unsigned int triangle) {
+            const Mesh::Triangle& tri = triangles[triangle];
+            packet.intersectTriangle(x[tri.v1], x[tri.v2], x[tri.v3], t, triangle);
+        });
+    }
+
+    for (unsigned int lane = 0; lane < rays.size(); ++lane)
+    {
+        RayHit& hit = hits[lane];
+        hit = RayHit{};
+        if (!packet.hasHit(lane)) continue;
+
+        const Target& target = m_targets[packet.target[lane]];
+        hit.object = target.object;
+        hit.triangle = packet.triangle[lane];
+        hit.distance = packet.maxT[lane];
+        hit.position = rays[lane].origin + glm::normalize(rays[lane].direction) * hit.distance;
+        hit.barycentric = glm::vec3(1.0f - packet.u[lane] - packet.v[lane], packet.u[lane], packet.v[lane]);
+        hit.hit = true;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <limits>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+
+class Object;
+
+struct Ray
+{
+    glm::vec3 origin;
+    glm::vec3 direction; // needn't be normalised; hit distances are along its unit length
+    float maxDistance = std::numeric_limits<float>::max();
+};
+
+struct RayHit
+{
+    Object* object = nullptr;
+    unsigned int triangle = 0; // into the object's surface triangles
+    float distance = std::numeric_limits<float>::max();
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 barycentric = glm::vec3(0.0f);
+    bool hit = false;
+};
+
+// Closest-hit ray queries against the surface triangles of deformable objects. Rays are traced
+// in packets of eight through each object's triangle tree, so batches of rays that start and
+// point close together, like a sensor's fan or a grid of drape probes, share most node visits.
+class RayCaster
+{
+public:
+    // Snapshots the objects' particle positions and refits their triangle trees to them
+    void prepare(const std::vector<Object*>& objects);
+
+    // Writes the closest hit of every ray into hits, which must be at least as long; packets are
+    // spread over the pool's workers when one is given
+    void cast(std::span<const Ray> rays, std::span<RayHit> hits, ThreadPool* pool = nullptr) const;
+
+private:
+    struct Target
+    {
+        Object* object;
+        std::vector<glm::vec3> positions;
+    };
+
+    void castPacket(std::span<const Ray> rays, std::span<RayHit> hits) const;
+
+private:
+    std::vector<Target> m_targets;
+};
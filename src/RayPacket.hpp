@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glm/glm.hpp>
+
+#include "Aabb.hpp"
+
+// Eight rays traced together, stored as separate arrays per component so the box and triangle
+// tests below run one loop over the lanes, which the compiler turns into vector instructions.
+// Each lane also keeps its closest hit so far; its maxT shrinks to the hit distance, so farther
+// boxes and triangles are culled for that ray.
+struct RayPacket
+{
+    static constexpr unsigned int SIZE = 8;
+    static constexpr unsigned int NO_HIT = std::numeric_limits<unsigned int>::max();
+
+    alignas(32) float ox[SIZE], oy[SIZE], oz[SIZE];
+    alignas(32) float dx[SIZE], dy[SIZE], dz[SIZE];
+    alignas(32) float inverseDx[SIZE], inverseDy[SIZE], inverseDz[SIZE];
+    alignas(32) float maxT[SIZE];
+
+    alignas(32) float u[SIZE], v[SIZE];
+    alignas(32) unsigned int target[SIZE];
+    alignas(32) unsigned int triangle[SIZE];
+
+    // Every lane starts unused: maxT below zero fails every test
+    RayPacket()
+    {
+        for (unsigned int i = 0; i < SIZE; ++i)
+        {
+            ox[i] = oy[i] = oz[i] = 0.0f;
+            dx[i] = dy[i] = dz[i] = 1.0f;
+            inverseDx[i] = inverseDy[i] = inverseDz[i] = 1.0f;
+            maxT[i] = -1.0f;
+            u[i] = v[i] = 0.0f;
+            target[i] = triangle[i] = NO_HIT;
+        }
+    }
+
+    void setRay(unsigned int lane, const glm::vec3& origin, const glm::vec3& direction, float maxDistance)
+    {
+        ox[lane] = origin.x;
+        oy[lane] = origin.y;
+        oz[lane] = origin.z;
+        dx[lane] = direction.x;
+        dy[lane] = direction.y;
+        dz[lane] = direction.z;
+        inverseDx[lane] = 1.0f / direction.x;
+        inverseDy[lane] = 1.0f / direction.y;
+        inverseDz[lane] = 1.0f / direction.z;
+        maxT[lane] = maxDistance;
+    }
+
+    bool hasHit(unsigned int lane) const { return triangle[lane] != NO_HIT; }
+
+    // Slab test of every lane against the box; tEnter is the nearest entry of the lanes that hit
+    bool intersects(const Aabb& box, float& tEnter) const
+    {
+        float nearest = std::numeric_limits<float>::max();
+        int anyHit = 0;
+        for (unsigned int i = 0; i < SIZE; ++i)
+        {
+            float t0x = (box.min.x - ox[i]) * inverseDx[i], t1x = (box.max.x - ox[i]) * inverseDx[i];
+            float t0y = (box.min.y - oy[i]) * inverseDy[i], t1y = (box.max.y - oy[i]) * inverseDy[i];
+            float t0z = (box.min.z - oz[i]) * inverseDz[i], t1z = (box.max.z - oz[i]) * inverseDz[i];
+            float tNear = std::max(std::max(std::min(t0x, t1x), std::min(t0y, t1y)), std::max(std::min(t0z, t1z), 0.0f));
+            float tFar = std::min(std::min(std::max(t0x, t1x), std::max(t0y, t1y)), std::min(std::max(t0z, t1z), maxT[i]));
+            int hit = tNear <= tFar;
+            anyHit |= hit;
+            nearest = hit ? std::min(nearest, tNear) : nearest;
+        }
+        tEnter = nearest;
+        return anyHit != 0;
+    }
+
+    // Möller–Trumbore against every lane at once, keeping the hit for lanes where it is the closest yet
+    void intersectTriangle(
+        const glm::vec3& a, const glm::vec3& b, const glm::vec3& c,
+        unsigned int targetIndex, unsigned int triangleIndex
+    )
+    {
+        constexpr float epsilon = std::numeric_limits<float>::epsilon();
+
+        const glm::vec3 edge1 = b - a, edge2 = c - a;
+        for (unsigned int i = 0; i < SIZE; ++i)
+        {
+            // p = d x edge2, s = o - a, q = s x edge1
+            float px = dy[i] * edge2.z - dz[i] * edge2.y;
+            float py = dz[i] * edge2.x - dx[i] * edge2.z;
+            float pz = dx[i] * edge2.y - dy[i] * edge2.x;
+            float determinant = edge1.x * px + edge1.y * py + edge1.z * pz;
+            float inverseDeterminant = 1.0f / determinant;
+
+            float sx = ox[i] - a.x, sy = oy[i] - a.y, sz = oz[i] - a.z;
+            float hitU = (sx * px + sy * py + sz * pz) * inverseDeterminant;
+
+            float qx = sy * edge1.z - sz * edge1.y;
+            float qy = sz * edge1.x - sx * edge1.z;
+            float qz = sx * edge1.y - sy * edge1.x;
+            float hitV = (dx[i] * qx + dy[i] * qy + dz[i] * qz) * inverseDeterminant;
+            float t = (edge2.x * qx + edge2.y * qy + edge2.z * qz) * inverseDeterminant;
+
+            bool hit = (std::abs(determinant) > epsilon) & (hitU >= 0.0f) & (hitV >= 0.0f) & (hitU + hitV <= 1.0f)
+                & (t > epsilon) & (t < maxT[i]);
+            maxT[i] = hit ? t : maxT[i];
+            u[i] = hit ? hitU : u[i];
+            v[i] = hit ? hitV : v[i];
+            target[i] = hit ? targetIndex : target[i];
+            triangle[i] = hit ? triangleIndex : triangle[i];
+        }
+    }
+};
@@ -0,0 +1,113 @@
+#include <algorithm>
+
+#include "RenderQueue.hpp"
+#include "Object.hpp"
+
+namespace
+{
+    // Program and texture names get 24 bits each, most expensive switch in the highest bits
+    uint64_t makeKey(const RenderQueue::DrawState& drawState)
+    {
+        uint64_t polygonMode = drawState.polygonMode == GL_FILL ? 0 : drawState.polygonMode == GL_LINE ? 1 : 2;
+        return (static_cast<uint64_t>(drawState.program & 0xFFFFFF) << 40)
+            | (static_cast<uint64_t>(drawState.texture & 0xFFFFFF) << 16)
+            | (polygonMode << 1)
+            | static_cast<uint64_t>(drawState.cullFace);
+    }
+}
+
+void RenderQueue::setInstancing(GLuint program, const Shader* shader)
+{
+    destroy();
+    m_instancedProgram = program;
+    m_instancedShader = shader;
+}
+
+void RenderQueue::add(const DrawState& drawState, Object* object)
+{
+    const MeshAdjacency* topology = nullptr;
+    if (m_instancedShader && drawState.program == m_instancedProgram)
+    {
+        topology = &object->getMesh().getAdjacency();
+    }
+    m_items.push_back({ makeKey(drawState), drawState, object, topology });
+}
+
+void RenderQueue::execute(RenderState& state, float barrierSize)
+{
+    // Copies of one mesh end up next to each other within a state group
+    std::stable_sort(m_items.begin(), m_items.end(), [](const Item& a, const Item& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return reinterpret_cast<uintptr_t>(a.topology) < reinterpret_cast<uintptr_t>(b.topology);
+    });
+
+    m_usedBatches.clear();
+    for (size_t i = 0; i < m_items.size();)
+    {
+        const Item& first = m_items[i];
+        size_t end = i + 1;
+        if (first.topology)
+        {
+            while (end < m_items.size() && m_items[end].key == first.key && m_items[end].topology == first.topology) ++end;
+        }
+
+        if (end - i >= MIN_INSTANCES)
+        {
+            m_members.clear();
+            for (size_t j = i; j < end; ++j)
+            {
+                m_members.push_back(m_items[j].object);
+            }
+
+            BatchKey batchKey(first.key, reinterpret_cast<uintptr_t>(first.topology));
+            const DrawState& drawState = first.drawState;
+            state.setPolygonMode(drawState.polygonMode);
+            state.setCullFace(drawState.cullFace);
+            state.setLineWidth(drawState.lineWidth);
+            if (m_batches[batchKey].draw(m_members, drawState.texture, state, *m_instancedShader))
+            {
+                m_usedBatches.push_back(batchKey);
+                i = end;
+                continue;
+            }
+        }
+
+        for (; i < end; ++i)
+        {
+            drawItem(m_items[i], state, barrierSize);
+        }
+    }
+
+    // Batches whose members changed state or left the scene
+    for (auto it = m_batches.begin(); it != m_batches.end();)
+    {
+        if (std::find(m_usedBatches.begin(), m_usedBatches.end(), it->first) == m_usedBatches.end())
+        {
+            it->second.destroy();
+            it = m_batches.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void RenderQueue::drawItem(const Item& item, RenderState& state, float barrierSize)
+{
+    const DrawState& drawState = item.drawState;
+    state.useProgram(drawState.program);
+    state.setPolygonMode(drawState.polygonMode);
+    state.setCullFace(drawState.cullFace);
+    state.setLineWidth(drawState.lineWidth);
+    item.object->draw(item, state, barrierSize);
+}
+
+void RenderQueue::destroy()
+{
+    for (auto& [key, batch] : m_batches)
+    {
+        batch.destroy();
+    }
+    m_batches.clear();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+#include <glad.h>
+
+#include "InstanceBatch.hpp"
+#include "RenderState.hpp"
+#include "Shader.hpp"
+
+class Object;
+class MeshAdjacency;
+
+// One frame's surface draws, sorted by the state they need so items sharing a program, texture, polygon
+// mode and culling run back to back, and the state cache turns the repeats into no-ops. Surfaces
+// that also share a mesh are merged into instanced draws when an instanced shader is set.
+class RenderQueue
+{
+public:
+    static constexpr size_t MIN_INSTANCES = 2;
+
+    struct DrawState
+    {
+        GLuint program;
+        GLuint texture; // 0 for untextured
+        GLenum polygonMode;
+        bool cullFace;
+        float lineWidth;
+    };
+
+    struct Item
+    {
+        uint64_t key;
+        DrawState drawState;
+        Object* object;
+        const MeshAdjacency* topology; // set for surfaces that can be instanced
+    };
+
+    // Surfaces drawn with program can instead be drawn in batches with shader, which reads the
+    // same inputs per instance
+    void setInstancing(GLuint program, const Shader* shader);
+
+    void clear() { m_items.clear(); }
+    void add(const DrawState& drawState, Object* object);
+
+    // Sorts the items by key, keeping submission order among equal keys, and draws them
+    void execute(RenderState& state, float barrierSize);
+
+    // Releases the batches' buffers; they are rebuilt on the next execute
+    void destroy();
+
+    size_t size() const { return m_items.size(); }
+
+private:
+    using BatchKey = std::pair<uint64_t, uintptr_t>;
+
+    void drawItem(const Item& item, RenderState& state, float barrierSize);
+
+private:
+    std::vector<Item> m_items;
+
+    GLuint m_instancedProgram = 0;
+    const Shader* m_instancedShader = nullptr;
+    std::map<BatchKey, InstanceBatch> m_batches;
+    std::vector<BatchKey> m_usedBatches;
+    std::vector<Object*> m_members;
+};
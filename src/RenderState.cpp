@@ -0,0 +1,109 @@
+#include "RenderState.hpp"
+
+void RenderState::beginFrame()
+{
+    m_program = UNKNOWN;
+    m_texture = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_polygonMode = 0;
+    m_cullFace = -1;
+    m_lineWidth = -1.0f;
+    m_stats = {};
+}
+
+void RenderState::useProgram(GLuint program)
+{
+    if (program == m_program)
+    {
+        ++m_stats.skipped;
+        return;
+    }
+    glUseProgram(program);
+    m_program = program;
+    ++m_stats.calls;
+}
+
+void RenderState::bindTexture(GLuint texture)
+{
+    if (texture == m_texture)
+    {
+        ++m_stats.skipped;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    m_texture = texture;
+    ++m_stats.calls;
+}
+
+void RenderState::bindVertexArray(GLuint vertexArray)
+{
+    if (vertexArray == m_vertexArray)
+    {
+        ++m_stats.skipped;
+        return;
+    }
+    glBindVertexArray(vertexArray);
+    m_vertexArray = vertexArray;
+    ++m_stats.calls;
+}
+
+void RenderState::setPolygonMode(GLenum mode)
+{
+    if (mode == m_polygonMode)
+    {
+        ++m_stats.skipped;
+        return;
+    }
+    glPolygonMode(GL_FRONT_AND_BACK, mode);
+    m_polygonMode = mode;
+    ++m_stats.calls;
+}
+
+void RenderState::setCullFace(bool enabled)
+{
+    if (static_cast<int>(enabled) == m_cullFace)
+    {
+        ++m_stats.skipped;
+        return;
+    }
+    if (enabled)
+    {
+        glEnable(GL_CULL_FACE);
+    }
+    else
+    {
+        glDisable(GL_CULL_FACE);
+    }
+    m_cullFace = enabled;
+    ++m_stats.calls;
+}
+
+void RenderState::setLineWidth(float width)
+{
+    if (width == m_lineWidth)
+    {
+        ++m_stats.skipped;
+        return;
+    }
+    glLineWidth(width);
+    m_lineWidth = width;
+    ++m_stats.calls;
+}
+
+void RenderState::setUniform(const Shader& shader, const std::string& name, const glm::vec3& value)
+{
+    shader.setVec3(name, value);
+    ++m_stats.calls;
+}
+
+void RenderState::setUniform(const Shader& shader, const std::string& name, float value)
+{
+    shader.setFloat(name, value);
+    ++m_stats.calls;
+}
+
+void RenderState::setUniform(const Shader& shader, const std::string& name, int value)
+{
+    shader.setInt(name, value);
+    ++m_stats.calls;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <glad.h>
+#include <glm/glm.hpp>
+
+#include "Shader.hpp"
+
+// Shadow copy of the GL state the scene's draws change, so asking for the state that is already
+// set makes no GL call. The calls the draw list makes go through here and are counted per frame.
+class RenderState
+{
+public:
+    struct Stats
+    {
+        unsigned int calls = 0;   // GL calls issued, draws included; one-time buffer setup isn't
+        unsigned int skipped = 0; // redundant state changes filtered out
+        unsigned int draws = 0;
+        unsigned int uploads = 0; // vertex buffers streamed
+    };
+
+    // Forgets the shadow state, which other code (ImGui) changes between frames, and resets the counters
+    void beginFrame();
+
+    void useProgram(GLuint program);
+    void bindTexture(GLuint texture); // GL_TEXTURE_2D on unit 0
+    void bindVertexArray(GLuint vertexArray);
+    void setPolygonMode(GLenum mode);
+    void setCullFace(bool enabled);
+    void setLineWidth(float width);
+
+    // After code that bound a vertex array directly, like buffer setup
+    void invalidateVertexArray() { m_vertexArray = UNKNOWN; }
+
+    void setUniform(const Shader& shader, const std::string& name, const glm::vec3& value);
+    void setUniform(const Shader& shader, const std::string& name, float value);
+    void setUniform(const Shader& shader, const std::string& name, int value);
+
+    // Calls made directly by the draw code
+    void countCalls(unsigned int count) { m_stats.calls += count; }
+    void countDraw() { ++m_stats.calls; ++m_stats.draws; }
+    void countUpload() { ++m_stats.uploads; }
+
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    static constexpr GLuint UNKNOWN = ~0u;
+
+    GLuint m_program = UNKNOWN;
+    GLuint m_texture = UNKNOWN;
+    GLuint m_vertexArray = UNKNOWN;
+    GLenum m_polygonMode = 0;
+    int m_cullFace = -1;
+    float m_lineWidth = -1.0f;
+
+    Stats m_stats;
+};
@@ -6,19 +6,21 @@
 
 
 // Scene configuration
-static constexpr std::array<std::pair<std::string_view, std::string_view>, 2> SCENE_LIST = {{
+static constexpr std::array<std::pair<std::string_view, std::string_view>, 4> SCENE_LIST = {{
     {"Sphere Scene", "sphereScene.yaml"},
-    {"Cloth Scene", "clothScene.yaml"}
+    {"Cloth Scene", "clothScene.yaml"},
+    {"Generated Scene", "generatedScene.yaml"},
+    {"Colliders Scene", "collidersScene.yaml"}
     // {"Cubes Scene", "cubesScene.yaml"}
 }};
 
 // Shader configuration
 static constexpr std::array<std::tuple<std::string_view, std::string_view, std::string_view>, 5> SHADER_DATA = {{
-    {"vertexNormal", "vertexNormal.vsh", "vertexNormal.fsh"},
-    {"faceNormal", "faceNormal.vsh", "faceNormal.fsh"},
+    {"debug", "debug.vsh", "debug.fsh"},
     {"ground", "ground.vsh", "ground.fsh"},
     {"light", "light.vsh", "light.fsh"},
     {"default", "default.vsh", "default.fsh"},
+    {"instanced", "instanced.vsh", "default.fsh"},
 }};
 
 // Mesh configuration
@@ -30,7 +32,7 @@ static constexpr std::array<std::pair<std::string_view, std::string_view>, 4> ME
 }};
 
 // Texture configuration
-static constexpr std::array<std::pair<std::string_view, std::string_view>, 4> TEXTURE_DATA = {{
+static constexpr std::array<std::pair<std::string_view, std::string_view>, 2> TEXTURE_DATA = {{
     {"dirtblock", "dirtblock.jpg"},
     {"checkerboard", "checkerboard.png"},
 }};
\ No newline at end of file
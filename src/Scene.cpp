@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fstream>
 #include <memory>
 #include <yaml-cpp/yaml.h>
@@ -5,8 +6,14 @@
 #include "logger.hpp"
 #include "Scene.hpp"
 
-Shader Object::s_vertexNormalShader;
-Shader Object::s_faceNormalShader;
+const std::string SDF_CACHE_PATH = "../cache/sdf/";
+constexpr float SDF_RESOLUTION = 64.0f;
+
+const uint32_t ENV_BVH_NODE_COLOR = DebugDraw::packColor(glm::vec4(0.6f, 0.6f, 0.6f, 1.0f));
+const uint32_t ENV_BVH_LEAF_COLOR = DebugDraw::packColor(glm::vec4(0.3f, 0.3f, 0.3f, 1.0f));
+const uint32_t CONTACT_COLOR = DebugDraw::packColor(glm::vec4(1.0f, 0.0f, 1.0f, 1.0f));
+const uint32_t EDGE_CONTACT_COLOR = DebugDraw::packColor(glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+constexpr float CONTACT_NORMAL_LENGTH = 0.3f;
 
 std::unique_ptr<Camera> Scene::createCamera() {
     float aspectRatio = static_cast<float>(m_screenWidth) / static_cast<float>(m_screenHeight);
@@ -27,14 +34,19 @@ std::unique_ptr<Object> Scene::createObject(
 {
     logger::info("  - Creating '{}' object...", config.name);
     Transform transform;
-    transform.setProjection(*m_camera);
 
     glm::mat4 model = glm::translate(glm::mat4(1.0f), config.position);
     model = glm::rotate(model, glm::radians(config.rotationDeg), config.rotationAxis);
     model = glm::scale(model, config.scale);
 
+    // Kinematic objects start at their first keyframe, which their motion is taken relative to
+    if (config.animation) {
+        KinematicAnimation::Pose start = config.animation->sample(0.0f);
+        model = glm::translate(glm::mat4(1.0f), start.position) * glm::mat4_cast(start.rotation);
+        model = glm::scale(model, config.scale);
+    }
+
     transform.setModel(model);
-    transform.setView(*m_camera);
 
     auto shaderOpt = m_shaderManager->getResource(config.shaderName);
     if (!shaderOpt) {
@@ -42,7 +54,9 @@ std::unique_ptr<Object> Scene::createObject(
         return nullptr;
     }
 
-    auto meshOpt = m_meshManager->getResource(config.meshName);
+    auto meshOpt = config.meshGenerator
+        ? getGeneratedMesh(*config.meshGenerator)
+        : m_meshManager->getResource(config.meshName);
     if (!meshOpt) {
         logger::error("    - Mesh '{}' not found for object '{}'", config.meshName, config.name);
         return nullptr;
@@ -55,6 +69,7 @@ std::unique_ptr<Object> Scene::createObject(
             logger::error("    - Texture '{}' not found for object '{}'", config.textureName, config.name);
             return nullptr;
         }
+        textureOpt->get().request();
     } else {
         logger::warning("- Texture intentionally left empty for object '{}'", config.name);
     }
@@ -84,11 +99,36 @@ std::unique_ptr<Object> Scene::createObject(
     }
 }
 
+std::optional<std::reference_wrapper<Mesh>> Scene::getGeneratedMesh(
+    const MeshGenerator::Config& config
+)
+{
+    // Generated meshes are shared through the mesh manager like file meshes
+    std::string name = MeshGenerator::getName(config);
+    auto meshOpt = m_meshManager->getResource(name);
+    if (meshOpt) {
+        return meshOpt;
+    }
+
+    try {
+        std::vector<std::unique_ptr<Mesh>> meshes;
+        meshes.push_back(std::make_unique<Mesh>(name, MeshGenerator::generate(config)));
+        m_meshManager->addResources(std::move(meshes));
+        logger::info("    - Generated '{}' mesh", name);
+    } catch (const std::exception& e) {
+        logger::error("    - Failed to generate mesh '{}': {}", name, e.what());
+        return std::nullopt;
+    }
+
+    return m_meshManager->getResource(name);
+}
+
 void Scene::createObjects(
     const SceneConfig& config
 )
 {
     logger::info(" - Creating '{}' scene objects...", config.name);
+    std::vector<Object*> sdfObjects;
     for (const auto& config : config.objects) {
         auto obj = createObject(config);
         if (!obj) {
@@ -96,10 +136,38 @@ void Scene::createObjects(
             continue;
         }
 
+        if (config.selfCollision) {
+            obj->enableSelfCollision();
+        }
+
+        if (config.hardEdges) {
+            obj->getMesh().setHardEdges(true);
+        }
+
+        if (config.animation) {
+            if (config.isStatic) {
+                obj->makeKinematic(*config.animation);
+            } else {
+                logger::warning("    - Only static objects can be animated, '{}' ignores its keyframes", config.name);
+            }
+        }
+
+        if (config.collider == "sdf") {
+            if (obj->isKinematic()) {
+                logger::warning("    - Kinematic object '{}' can't use an SDF collider, keeping its mesh", config.name);
+            } else if (config.isStatic) {
+                sdfObjects.push_back(obj.get());
+            } else {
+                logger::warning("    - Only static objects can use an SDF collider, '{}' keeps its mesh", config.name);
+            }
+        } else if (config.collider != "mesh") {
+            logger::warning("    - Unknown collider '{}' for object '{}', using its mesh", config.collider, config.name);
+        }
+
         m_objects.push_back(std::move(obj));
     }
 
-    setupEnvCollisionConstraints();
+    setupEnvCollisionConstraints(sdfObjects);
 }
 
 void Scene::loadSceneConfig(
@@ -118,19 +186,27 @@ void Scene::loadSceneConfig(
     SceneConfig sceneConfig = parseSceneConfig(sceneYaml);
     m_name = sceneConfig.name;
 
-    auto vertexNormalShaderOpt = m_shaderManager->getResource("vertexNormal");
-    auto faceNormalShaderOpt = m_shaderManager->getResource("faceNormal");
+    if (sceneConfig.colliders) {
+        m_colliders = *sceneConfig.colliders;
+    } else {
+        setupDefaultColliders();
+    }
 
-    if (!vertexNormalShaderOpt) {
-        logger::error("Failed to load 'vertexNormal' shader for all objects");
+    auto debugShaderOpt = m_shaderManager->getResource("debug");
+    if (!debugShaderOpt) {
+        logger::error("Failed to load 'debug' shader, normals and debug overlays won't be drawn");
+        m_debugShader = nullptr;
     } else {
-        Object::setVertexNormalShader(vertexNormalShaderOpt->get());
+        m_debugShader = &debugShaderOpt->get();
     }
 
-    if (!faceNormalShaderOpt) {
-        logger::error("Failed to load 'faceNormal' shader for all objects");
+    // Copies of a mesh drawn with the default shader are batched into instanced draws
+    auto defaultShaderOpt = m_shaderManager->getResource("default");
+    auto instancedShaderOpt = m_shaderManager->getResource("instanced");
+    if (defaultShaderOpt && instancedShaderOpt) {
+        m_renderQueue.setInstancing(defaultShaderOpt->get().getID(), &instancedShaderOpt->get());
     } else {
-        Object::setFaceNormalShader(faceNormalShaderOpt->get());
+        logger::warning("Instancing disabled, 'default' or 'instanced' shader missing");
     }
 
     createObjects(sceneConfig);
@@ -164,7 +240,23 @@ SceneConfig Scene::parseSceneConfig(
             objYaml["scale"][2].as<float>()
         );
         objConfig.shaderName = objYaml["shader"].as<std::string>();
-        objConfig.meshName = objYaml["mesh"].as<std::string>();
+        const auto& meshYaml = objYaml["mesh"];
+        if (meshYaml.IsMap()) {
+            MeshGenerator::Config generatorConfig;
+            generatorConfig.type = meshYaml["generator"].as<std::string>();
+
+            const auto& resolutionYaml = meshYaml["subdivisions"] ? meshYaml["subdivisions"] : meshYaml["resolution"];
+            if (resolutionYaml.IsSequence()) {
+                generatorConfig.resolution = resolutionYaml.as<std::vector<unsigned int>>();
+            } else if (resolutionYaml) {
+                generatorConfig.resolution = { resolutionYaml.as<unsigned int>() };
+            }
+
+            objConfig.meshName = MeshGenerator::getName(generatorConfig);
+            objConfig.meshGenerator = generatorConfig;
+        } else {
+            objConfig.meshName = meshYaml.as<std::string>();
+        }
         objConfig.textureName = objYaml["texture"].as<std::string>();
         objConfig.color = glm::vec3(
             objYaml["color"][0].as<float>(),
@@ -172,31 +264,148 @@ SceneConfig Scene::parseSceneConfig(
             objYaml["color"][2].as<float>()
         );
         objConfig.isStatic = objYaml["isStatic"].as<bool>();
+        if (objYaml["selfCollision"]) {
+            objConfig.selfCollision = objYaml["selfCollision"].as<bool>();
+        }
+        if (objYaml["hardEdges"]) {
+            objConfig.hardEdges = objYaml["hardEdges"].as<bool>();
+        }
+        if (objYaml["collider"]) {
+            objConfig.collider = objYaml["collider"].as<std::string>();
+        }
+        if (objYaml["animation"]) {
+            objConfig.animation = parseAnimation(objYaml["animation"], objConfig);
+        }
 
         config.objects.push_back(objConfig);
     }
 
+    if (sceneYaml["scene"]["colliders"]) {
+        config.colliders = parseColliders(sceneYaml["scene"]["colliders"]);
+    }
+
     return config;
 }
 
-// TODO : fixme
-void Scene::setupEnvCollisionConstraints() {
-    // Build list of static objects once
+ColliderSet Scene::parseColliders(
+    const YAML::Node& collidersYaml
+)
+{
+    auto vec3 = [](const YAML::Node& node) {
+        return glm::vec3(node[0].as<float>(), node[1].as<float>(), node[2].as<float>());
+    };
+
+    ColliderSet colliders;
+    for (const auto& colliderYaml : collidersYaml) {
+        const std::string type = colliderYaml["type"].as<std::string>();
+        if (type == "plane") {
+            colliders.addPlane(vec3(colliderYaml["normal"]), colliderYaml["offset"].as<float>());
+        } else if (type == "sphere") {
+            colliders.addSphere(vec3(colliderYaml["center"]), colliderYaml["radius"].as<float>());
+        } else if (type == "box") {
+            colliders.addBox(vec3(colliderYaml["center"]), vec3(colliderYaml["halfExtents"]));
+        } else if (type == "capsule") {
+            colliders.addCapsule(vec3(colliderYaml["start"]), vec3(colliderYaml["end"]), colliderYaml["radius"].as<float>());
+        } else {
+            logger::warning(" - Unknown collider type '{}' ignored", type);
+        }
+    }
+
+    return colliders;
+}
+
+KinematicAnimation Scene::parseAnimation(
+    const YAML::Node& animationYaml,
+    const ObjectConfig& objConfig
+)
+{
+    // Keyframes default to the object's own position and rotation, so each only lists what changes
+    std::vector<KinematicAnimation::Keyframe> keyframes;
+    for (const auto& keyframeYaml : animationYaml["keyframes"]) {
+        KinematicAnimation::Keyframe keyframe;
+        keyframe.time = keyframeYaml["time"].as<float>();
+
+        glm::vec3 position = objConfig.position;
+        if (keyframeYaml["position"]) {
+            position = glm::vec3(
+                keyframeYaml["position"][0].as<float>(),
+                keyframeYaml["position"][1].as<float>(),
+                keyframeYaml["position"][2].as<float>()
+            );
+        }
+        glm::vec3 rotationAxis = objConfig.rotationAxis;
+        if (keyframeYaml["rotationAxis"]) {
+            rotationAxis = glm::vec3(
+                keyframeYaml["rotationAxis"][0].as<float>(),
+                keyframeYaml["rotationAxis"][1].as<float>(),
+                keyframeYaml["rotationAxis"][2].as<float>()
+            );
+        }
+        float rotationDeg = keyframeYaml["rotationDeg"] ? keyframeYaml["rotationDeg"].as<float>() : objConfig.rotationDeg;
+
+        keyframe.pose.position = position;
+        keyframe.pose.rotation = glm::angleAxis(glm::radians(rotationDeg), glm::normalize(rotationAxis));
+        keyframes.push_back(keyframe);
+    }
+
+    bool loop = animationYaml["loop"] ? animationYaml["loop"].as<bool>() : true;
+    return KinematicAnimation(std::move(keyframes), loop);
+}
+
+void Scene::setupDefaultColliders() {
+    // Scenes without a collider list keep the old ground plane and square barrier
+    constexpr float groundLevel = 0.1f;
+    m_colliders.clear();
+    m_colliders.addPlane(glm::vec3(0.0f, 1.0f, 0.0f), groundLevel);
+    m_colliders.addPlane(glm::vec3(1.0f, 0.0f, 0.0f), -m_barrierSize);
+    m_colliders.addPlane(glm::vec3(-1.0f, 0.0f, 0.0f), -m_barrierSize);
+    m_colliders.addPlane(glm::vec3(0.0f, 0.0f, 1.0f), -m_barrierSize);
+    m_colliders.addPlane(glm::vec3(0.0f, 0.0f, -1.0f), -m_barrierSize);
+}
+
+void Scene::setupEnvCollisionConstraints(
+    const std::vector<Object*>& sdfObjects
+)
+{
+    // Static geometry never moves, so its triangles go into one BVH up front; kinematic objects get
+    // trees of their own that are refitted as they move
     std::vector<Object*> staticObjects;
     staticObjects.reserve(m_objects.size());
     for (const auto& obj : m_objects) {
-        if (obj->isStatic()) {
+        if (obj->isStatic() && std::find(sdfObjects.begin(), sdfObjects.end(), obj.get()) == sdfObjects.end()) {
             staticObjects.push_back(obj.get());
         }
     }
 
-    // Only set collision constraints between dynamic objects and static geometry
-    for (const auto& obj : m_objects) {
-        if (obj->isStatic()) continue;
+    m_envCollider.build(staticObjects);
+    logger::info(" - Built environment collision BVH over {} static and kinematic triangles", m_envCollider.getTriangleCount());
+
+    // Distance fields are baked once and reused from disk while the object's triangles stay the same
+    m_sdfColliders.clear();
+    for (Object* object : sdfObjects) {
+        Mesh& mesh = object->getMesh();
+        const auto& positions = mesh.getPositions();
 
-        Mesh& mesh = obj->getMesh();
-        mesh.setCandidateObjectMeshes(staticObjects);
-        mesh.constructEnvCollisionConstraints();
+        Aabb bounds;
+        for (const auto& position : positions) {
+            bounds.expand(position);
+        }
+        glm::vec3 extent = bounds.extent();
+        float cellSize = std::max({ extent.x, extent.y, extent.z, 1e-3f }) / SDF_RESOLUTION;
+        float bandWidth = std::max(4.0f * cellSize, 2.0f * m_collisionThickness);
+
+        SignedDistanceField sdf;
+        std::string cachePath = SDF_CACHE_PATH + m_name + "/" + object->getName() + ".sdf";
+        uint64_t sourceHash = SignedDistanceField::hashSource(positions, mesh.getAdjacency(), cellSize, bandWidth);
+        if (sdf.readCache(cachePath, sourceHash)) {
+            logger::info(" - Read '{}' distance field from cache", object->getName());
+        } else {
+            sdf.bake(positions, mesh.getAdjacency(), cellSize, bandWidth, m_threadPool.get());
+            sdf.writeCache(cachePath, sourceHash);
+            const glm::ivec3& resolution = sdf.getResolution();
+            logger::info(" - Baked '{}' distance field ({}x{}x{})", object->getName(), resolution.x, resolution.y, resolution.z);
+        }
+        m_sdfColliders.push_back(std::move(sdf));
     }
 }
 
@@ -218,11 +427,14 @@ Scene::Scene(
         m_meshManager(meshManager),
         m_textureManager(textureManager),
         m_gravitationalAcceleration(0.0f, 0.0f, 0.0f),
-        m_groundLevel(0.1f),
         m_barrierSize(30.0f),
         m_enableDistanceConstraints(true),
         m_enableVolumeConstraints(true),
         m_enableEnvCollisionConstraints(true),
+        m_collisionThickness(0.05f),
+        m_contactMargin(0.1f),
+        m_enableSelfCollisionConstraints(true),
+        m_enableObjectCollisionConstraints(true),
         m_xpbdSubsteps(1),
         m_alpha(0.001f),
         m_beta(1.0f),
@@ -294,86 +506,42 @@ void Scene::updateConstraintPositions(
     }
 }
 
-/* Möller–Trumbore intersection algorithm (See Wikipedia) */
-std::optional<glm::vec3> Scene::rayIntersectsTriangle(
+Scene::PickResult Scene::pickObject(
     const glm::vec3& rayOrigin,
-    const glm::vec3& rayDirection,
-    const Mesh::Triangle& triangle,
-    const std::vector<Transform>& vertexTransforms
+    const glm::vec3& rayDir
 )
 {
-    constexpr float epsilon = std::numeric_limits<float>::epsilon();
-
-    glm::vec3 v1 = vertexTransforms[triangle.v1].getPosition();
-    glm::vec3 v2 = vertexTransforms[triangle.v2].getPosition();
-    glm::vec3 v3 = vertexTransforms[triangle.v3].getPosition();
-
-    glm::vec3 edge1 = v2 - v1;
-    glm::vec3 edge2 = v3 - v1;
-    glm::vec3 rayCrossEdge2 = glm::cross(rayDirection, edge2);
-    float determinant = glm::dot(edge1, rayCrossEdge2);
-
-    if (determinant > -epsilon && determinant < epsilon) {
-        return {};
-    }
-
-    float inverseDeterminant = 1.0f / determinant;
-    glm::vec3 rayOriginToV1 = rayOrigin - v1;
-    float u = inverseDeterminant * glm::dot(rayOriginToV1, rayCrossEdge2);
-
-    if ((u < 0.0f && glm::abs(u) > epsilon) || (u > 1.0f && glm::abs(u - 1.0f) > epsilon)) {
-        return {};
+    std::vector<Object*> dynamicObjects;
+    for (const auto& objPtr : m_objects) {
+        if (!objPtr->isStatic()) dynamicObjects.push_back(objPtr.get());
     }
+    m_rayCaster.prepare(dynamicObjects);
 
-    glm::vec3 rayOriginToV1CrossEdge1 = glm::cross(rayOriginToV1, edge1);
-    float v = inverseDeterminant * glm::dot(rayDirection, rayOriginToV1CrossEdge1);
-
-    if ((v < 0.0f && glm::abs(v) > epsilon) || (u + v > 1.0f && glm::abs(u + v - 1.0f) > epsilon)) {
-        return {};
-    }
+    Ray ray{ rayOrigin, rayDir };
+    RayHit hit;
+    m_rayCaster.cast(std::span(&ray, 1), std::span(&hit, 1));
 
-    float t = inverseDeterminant * glm::dot(edge2, rayOriginToV1CrossEdge1);
-    if (t > epsilon) {
-        return glm::vec3(rayOrigin + rayDirection * t);
+    PickResult result;
+    if (hit.hit) {
+        result.object = hit.object;
+        result.triangle = hit.object->getMesh().mouseDistanceConstraints.triangles[hit.triangle];
+        result.intersection = hit.position;
+        result.hit = true;
     }
-
-    return {};
+    return result;
 }
 
-Scene::PickResult Scene::pickObject(
-    const glm::vec3& rayOrigin,
-    const glm::vec3& rayDir
+void Scene::castRays(
+    std::span<const Ray> rays,
+    std::span<RayHit> hits
 )
 {
-    PickResult result;
-    float closestDistance = std::numeric_limits<float>::max();
-
+    std::vector<Object*> objects;
     for (const auto& objPtr : m_objects) {
-        if (objPtr->isStatic()) continue;
-
-        auto& vertexTransforms = objPtr->getVertexTransforms();
-        const auto& triangles = objPtr->getMesh().mouseDistanceConstraints.triangles;
-        for (const auto& triangle : triangles) {
-            auto intersection = rayIntersectsTriangle(
-                rayOrigin,
-                rayDir,
-                triangle,
-                vertexTransforms
-            );
-            if (intersection) {
-                float dist = glm::distance(rayOrigin, intersection.value());
-                if (dist < closestDistance) {
-                    closestDistance = dist;
-                    result.object = objPtr.get();
-                    result.triangle = triangle;
-                    result.intersection = intersection.value();
-                    result.hit = true;
-                }
-            }
-        }
+        objects.push_back(objPtr.get());
     }
-
-    return result;
+    m_rayCaster.prepare(objects);
+    m_rayCaster.cast(rays, hits, m_threadPool.get());
 }
 
 void Scene::createMouseConstraints(
@@ -587,243 +755,383 @@ void Scene::computeVolumeConstraintEnergy(
     object.setVolumeConstraintEnergy(energy);
 }
 
-// TODO : fixme
 void Scene::solveEnvCollisionConstraints(
     std::vector<glm::vec3>& x,
-    const std::vector<glm::vec3>& posDiff,
     const std::vector<float>& M,
-    float alphaTilde,
-    float gamma,
-    std::vector<Mesh::EnvCollisionConstraints> perEnvCollisionConstraints
+    const std::vector<EnvContact>& contacts,
+    const std::vector<EnvEdgeContact>& edgeContacts,
+    float frameFraction
 )
 {
-    for (size_t setIdx = 0; setIdx < perEnvCollisionConstraints.size(); ++setIdx)
-    {
-        const auto& constraints = perEnvCollisionConstraints[setIdx];
-        size_t verticesSize = constraints.vertices.size();
-        size_t CSize = constraints.C.size();
-        size_t gradCSize = constraints.gradC.size();
-
-        if (verticesSize != gradCSize)
-        {
-            logger::error("EnvCollisionConstraints size mismatch in set {}", setIdx);
-            continue;
+    // Static side has infinite mass and contacts are stiff, so each projection is the full correction.
+    // Kinematic surfaces have moved frameFraction of their way through the frame, and the particles
+    // pushed along with them come out of the substep with the surface's normal velocity.
+    for (const auto& contact : contacts) {
+        glm::vec3& xi = x[contact.vertex];
+        float C = glm::dot(contact.normal, xi) - (contact.offset + frameFraction * contact.shift);
+        if (C < 0.0f) {
+            xi -= C * contact.normal;
         }
+    }
 
-        for (const auto& [vertex, constraintIndices] : constraints.vertexToConstraints)
-        {
-            bool allNegative = true;
-            float maxNegativeC = -std::numeric_limits<float>::max();
-            size_t maxIdx = 0;
-            for (size_t idx : constraintIndices)
-            {
-                float C_j = constraints.C[idx](x);
-                if (C_j >= 0.0f)
-                {
-                    allNegative = false;
-                }
-
-                // Track the constraint with biggest negative value
-                if (C_j < 0.0f && C_j > maxNegativeC)
-                {
-                    maxNegativeC = C_j;
-                    maxIdx = idx;
-                }
-            }
+    // An edge point moves its two particles by their share of the gradient (1 - s, s)
+    for (const auto& contact : edgeContacts) {
+        glm::vec3& x1 = x[contact.edge.v1];
+        glm::vec3& x2 = x[contact.edge.v2];
+        const float s = contact.s;
+        float C = glm::dot(contact.normal, (1.0f - s) * x1 + s * x2) - (contact.offset + frameFraction * contact.shift);
+        if (C >= 0.0f) continue;
+
+        float w1 = 1.0f / M[contact.edge.v1];
+        float w2 = 1.0f / M[contact.edge.v2];
+        float deltaLambda = -C / ((1.0f - s) * (1.0f - s) * w1 + s * s * w2);
+        x1 += w1 * deltaLambda * (1.0f - s) * contact.normal;
+        x2 += w2 * deltaLambda * s * contact.normal;
+    }
+}
+
+void Scene::solveSdfCollisionConstraints(
+    std::vector<glm::vec3>& x,
+    const std::vector<glm::vec3>& p,
+    std::span<const unsigned int> vertices
+)
+{
+    // One lookup per particle and field, pushed out along the gradient to the collision thickness
+    for (const auto& sdf : m_sdfColliders) {
+        for (unsigned int vertex : vertices) {
+            glm::vec3 gradient;
+            float distance = sdf.sample(x[vertex], gradient);
+            if (distance >= m_collisionThickness) continue;
+
+            // Particles that started behind the surface are left alone, like one-sided triangles
+            glm::vec3 startGradient;
+            if (sdf.sample(p[vertex], startGradient) < -m_collisionThickness) continue;
+
+            float length = glm::length(gradient);
+            if (length <= 0.0f) continue;
+            x[vertex] += ((m_collisionThickness - distance) / length) * gradient;
+        }
+    }
+}
 
-            // If all constraints are negative, we have a collision with this vertex
-            if (allNegative && !constraintIndices.empty())
-            {
-                float C_j = maxNegativeC;
-                std::vector<glm::vec3> gradC_j = constraints.gradC[maxIdx](x);
+void Scene::solveSelfCollisionConstraints(
+    std::vector<glm::vec3>& x,
+    const std::vector<float>& M,
+    const SelfCollider& selfCollider
+)
+{
+    // Contacts are stiff, so with zero compliance each XPBD step is a plain projection
+    const float thickness = selfCollider.getThickness();
+
+    for (const auto& contact : selfCollider.getPointContacts()) {
+        glm::vec3 d = x[contact.v1] - x[contact.v2];
+        float distance = glm::length(d);
+        float C = distance - thickness;
+        if (C >= 0.0f || distance <= 0.0f) continue;
+
+        float w1 = 1.0f / M[contact.v1];
+        float w2 = 1.0f / M[contact.v2];
+        glm::vec3 n = d / distance;
+        float deltaLambda = -C / (w1 + w2);
+        x[contact.v1] += w1 * deltaLambda * n;
+        x[contact.v2] -= w2 * deltaLambda * n;
+    }
 
-                std::array<unsigned int, 1> constraintVertices = { vertex };
+    for (const auto& contact : selfCollider.getTriangleContacts()) {
+        const auto& tri = contact.triangle;
+        glm::vec3 n = glm::cross(x[tri.v2] - x[tri.v1], x[tri.v3] - x[tri.v1]);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n *= contact.side / length;
+
+        const glm::vec3& b = contact.weights;
+        glm::vec3 surfacePoint = b.x * x[tri.v1] + b.y * x[tri.v2] + b.z * x[tri.v3];
+        float C = glm::dot(n, x[contact.vertex] - surfacePoint) - thickness;
+        if (C >= 0.0f) continue;
+
+        // Gradient is n on the particle and -b_i n on the triangle corners
+        float w = 1.0f / M[contact.vertex];
+        float w1 = 1.0f / M[tri.v1], w2 = 1.0f / M[tri.v2], w3 = 1.0f / M[tri.v3];
+        float deltaLambda = -C / (w + b.x * b.x * w1 + b.y * b.y * w2 + b.z * b.z * w3);
+        x[contact.vertex] += w * deltaLambda * n;
+        x[tri.v1] -= w1 * deltaLambda * b.x * n;
+        x[tri.v2] -= w2 * deltaLambda * b.y * n;
+        x[tri.v3] -= w3 * deltaLambda * b.z * n;
+    }
+}
 
-                float deltaLambda = calculateDeltaLambda(C_j, gradC_j, posDiff, constraintVertices, M, alphaTilde, gamma);
+void Scene::solveObjectCollisionConstraints(
+    const std::vector<CollisionBody>& bodies,
+    const SoftBodyCollider& softBodyCollider
+)
+{
+    // Same projection as a self-collision triangle contact, with the particle and triangle in different bodies
+    const float thickness = m_collisionThickness;
+
+    for (const auto& contact : softBodyCollider.getContacts()) {
+        std::vector<glm::vec3>& xa = *bodies[contact.body].x;
+        std::vector<glm::vec3>& xb = *bodies[contact.otherBody].x;
+        const std::vector<float>& Ma = *bodies[contact.body].M;
+        const std::vector<float>& Mb = *bodies[contact.otherBody].M;
+        const auto& tri = contact.triangle;
+
+        glm::vec3 n = glm::cross(xb[tri.v2] - xb[tri.v1], xb[tri.v3] - xb[tri.v1]);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n *= contact.side / length;
+
+        const glm::vec3& b = contact.weights;
+        glm::vec3 surfacePoint = b.x * xb[tri.v1] + b.y * xb[tri.v2] + b.z * xb[tri.v3];
+        float C = glm::dot(n, xa[contact.vertex] - surfacePoint) - thickness;
+        if (C >= 0.0f) continue;
+
+        float w = 1.0f / Ma[contact.vertex];
+        float w1 = 1.0f / Mb[tri.v1], w2 = 1.0f / Mb[tri.v2], w3 = 1.0f / Mb[tri.v3];
+        float deltaLambda = -C / (w + b.x * b.x * w1 + b.y * b.y * w2 + b.z * b.z * w3);
+        xa[contact.vertex] += w * deltaLambda * n;
+        xb[tri.v1] -= w1 * deltaLambda * b.x * n;
+        xb[tri.v2] -= w2 * deltaLambda * b.y * n;
+        xb[tri.v3] -= w3 * deltaLambda * b.z * n;
+    }
 
-                std::vector<glm::vec3> deltaX(M.size(), glm::vec3(0.0f));
-                setDeltaX(deltaX, deltaLambda, M, gradC_j, constraintVertices);
-                updateConstraintPositions(x, deltaX);
-            }
+    for (const auto& contact : softBodyCollider.getEdgeContacts()) {
+        std::vector<glm::vec3>& xa = *bodies[contact.body].x;
+        std::vector<glm::vec3>& xb = *bodies[contact.otherBody].x;
+        const std::vector<float>& Ma = *bodies[contact.body].M;
+        const std::vector<float>& Mb = *bodies[contact.otherBody].M;
+        const auto& ea = contact.edge;
+        const auto& eb = contact.otherEdge;
+        const float s = contact.s, u = contact.u;
+
+        glm::vec3 pointA = (1.0f - s) * xa[ea.v1] + s * xa[ea.v2];
+        glm::vec3 pointB = (1.0f - u) * xb[eb.v1] + u * xb[eb.v2];
+        float C = glm::dot(contact.normal, pointA - pointB) - thickness;
+        if (C >= 0.0f) continue;
+
+        float wa1 = 1.0f / Ma[ea.v1], wa2 = 1.0f / Ma[ea.v2];
+        float wb1 = 1.0f / Mb[eb.v1], wb2 = 1.0f / Mb[eb.v2];
+        float deltaLambda = -C / ((1.0f - s) * (1.0f - s) * wa1 + s * s * wa2 + (1.0f - u) * (1.0f - u) * wb1 + u * u * wb2);
+        xa[ea.v1] += wa1 * deltaLambda * (1.0f - s) * contact.normal;
+        xa[ea.v2] += wa2 * deltaLambda * s * contact.normal;
+        xb[eb.v1] -= wb1 * deltaLambda * (1.0f - u) * contact.normal;
+        xb[eb.v2] -= wb2 * deltaLambda * u * contact.normal;
+    }
+}
+
+void Scene::beginSubstep(
+    XPBDState& state,
+    float deltaTime_s
+)
+{
+    const auto& vertexTransforms = state.object->getVertexTransforms();
+    for (size_t i = 0; i < vertexTransforms.size(); ++i) {
+        const Transform& vt = vertexTransforms[i];
+        state.p[i] = vt.getPosition();
+        glm::vec3 v = vt.getVelocity() + deltaTime_s * vt.getAcceleration();
+        state.x[i] = state.p[i] + deltaTime_s * v;
+        state.posDiff[i] = state.x[i] - state.p[i];
+    }
+}
+
+void Scene::detectObjectContacts(XPBDState& state)
+{
+    const auto& mesh = state.object->getMesh();
+    const auto& x = state.x;
+    const auto& p = state.p;
+
+    if (m_enableEnvCollisionConstraints && !m_envCollider.empty()) {
+        state.envContacts.clear();
+        m_envCollider.detectContacts(
+            p,
+            x,
+            mesh.envCollisionConstraintVertices,
+            m_collisionThickness,
+            m_contactMargin,
+            state.envCache,
+            state.envContacts
+        );
+        state.envEdgeContacts.clear();
+        m_envCollider.detectEdgeContacts(
+            p,
+            x,
+            mesh.envCollisionConstraintEdges,
+            m_collisionThickness,
+            m_contactMargin,
+            state.envEdgeCache,
+            state.envEdgeContacts
+        );
+
+        for (const auto& contact : state.envContacts) {
+            state.envCache.record(contact.key, contact.side);
         }
+        state.envCache.commit();
+        for (const auto& contact : state.envEdgeContacts) {
+            state.envEdgeCache.record(contact.key, contact.side);
+        }
+        state.envEdgeCache.commit();
+    }
+
+    // Self collision, detected on the scene pool from inside this object's task
+    SelfCollider* selfCollider = state.object->getSelfCollider();
+    if (m_enableSelfCollisionConstraints && selfCollider) {
+        selfCollider->detectContacts(p, x, m_contactMargin, m_threadPool.get());
     }
 }
 
-void Scene::applyXPBD(
-    Object& object,
-    float deltaTime,
-    const glm::vec3& cameraPos,
-    const glm::vec3& rayDir
+void Scene::solveObjectConstraints(
+    XPBDState& state,
+    float deltaTime_s,
+    float frameFraction
 )
 {
+    Object& object = *state.object;
     const auto& mesh = object.getMesh();
     const auto& distanceConstraints = mesh.distanceConstraints;
     const auto& volumeConstraints = mesh.volumeConstraints;
-    const auto& perEnvCollisionConstraints = mesh.perEnvCollisionConstraints;
-
-    auto& vertexTransforms = object.getVertexTransforms();
-    const size_t numVerts = vertexTransforms.size();
-
-    std::vector<float> M = object.getMass();
-    std::vector<glm::vec3> x(numVerts);
-    std::vector<glm::vec3> v(numVerts);
-    std::vector<glm::vec3> p(numVerts);
-    std::vector<glm::vec3> posDiff(numVerts);
-
-    int subStep = 1;
-    const int n = m_xpbdSubsteps;
-    float deltaTime_s = deltaTime / static_cast<float>(n);
+    auto& x = state.x;
+    const auto& p = state.p;
+    const auto& M = state.M;
+    const auto& posDiff = state.posDiff;
 
     float alphaTilde = m_alpha / (deltaTime_s * deltaTime_s);
     float betaTilde  = (deltaTime_s * deltaTime_s) * m_beta;
     float gamma      = (alphaTilde * betaTilde) / deltaTime_s;
 
+    // Solve mouse constraints if active and
     if (m_activeMouseConstraint.object == &object && m_activeMouseConstraint.isActive) {
-        updateMouseConstraints(cameraPos, rayDir);
+        solveMouseConstraints(
+            x,
+            posDiff,
+            M,
+            deltaTime_s
+        );
     }
 
-    while (subStep < n + 1) {
-        for (size_t i = 0; i < numVerts; ++i) {
-            const Transform& vt = vertexTransforms[i];
-            p[i] = vt.getPosition();
-            v[i] = vt.getVelocity() + deltaTime_s * vt.getAcceleration();
-            x[i] = p[i] + deltaTime_s * v[i];
-            posDiff[i] = x[i] - p[i];
-        }
-
-        // Solve mouse constraints if active and
-        if (m_activeMouseConstraint.object == &object && m_activeMouseConstraint.isActive) {
-            solveMouseConstraints(
-                x,
-                posDiff,
-                M,
-                deltaTime_s
-            );
-        }
-
-        // Distance constraints
-        if (m_enableDistanceConstraints) {
-            solveDistanceConstraints(
-                x,
-                posDiff,
-                M,
-                alphaTilde,
-                gamma,
-                distanceConstraints
-            );
+    // Distance constraints
+    if (m_enableDistanceConstraints) {
+        solveDistanceConstraints(
+            x,
+            posDiff,
+            M,
+            alphaTilde,
+            gamma,
+            distanceConstraints
+        );
 
-            computeDistanceConstraintEnergy(
-                object,
-                x,
-                m_alpha,
-                distanceConstraints
-            );
-        }
+        computeDistanceConstraintEnergy(
+            object,
+            x,
+            m_alpha,
+            distanceConstraints
+        );
+    }
 
-        // Volume constraints
-        if (m_enableVolumeConstraints && m_name != "Cloth Scene") {
-            solveVolumeConstraints(
-                x,
-                posDiff,
-                M,
-                alphaTilde,
-                gamma,
-                volumeConstraints
-            );
+    // Volume constraints
+    if (m_enableVolumeConstraints && !volumeConstraints.C.empty()) {
+        solveVolumeConstraints(
+            x,
+            posDiff,
+            M,
+            alphaTilde,
+            gamma,
+            volumeConstraints
+        );
 
-            computeVolumeConstraintEnergy(
-                object,
-                x,
-                m_alpha,
-                volumeConstraints
-            );
-        }
+        computeVolumeConstraintEnergy(
+            object,
+            x,
+            m_alpha,
+            volumeConstraints
+        );
+    }
 
-        // Environment Collision constraints
-        if (m_enableEnvCollisionConstraints) {
-            solveEnvCollisionConstraints(
-                x,
-                posDiff,
-                M,
-                alphaTilde,
-                gamma,
-                perEnvCollisionConstraints
-            );
-        }
+    // Environment Collision constraints, from the contacts found at the start of the frame
+    if (m_enableEnvCollisionConstraints && !m_envCollider.empty()) {
+        solveEnvCollisionConstraints(x, M, state.envContacts, state.envEdgeContacts, frameFraction);
+    }
+    if (m_enableEnvCollisionConstraints && !m_sdfColliders.empty()) {
+        solveSdfCollisionConstraints(x, p, mesh.envCollisionConstraintVertices);
+    }
 
-        // Update positions and velocities
-        for (size_t i = 0; i < numVerts; ++i) {
-            Transform& vt = vertexTransforms[i];
-            glm::vec3 newV = (x[i] - p[i]) / deltaTime_s;
-            vt.setPosition(x[i]);
-            vt.setVelocity(newV);
-        }
+    // Scene colliders (ground, barrier, primitives) as contacts in the same substep
+    m_colliders.solve(x);
 
-        subStep++;
+    SelfCollider* selfCollider = object.getSelfCollider();
+    if (m_enableSelfCollisionConstraints && selfCollider) {
+        solveSelfCollisionConstraints(x, M, *selfCollider);
     }
 }
 
-void Scene::applyGroundCollision(Object& object) {
-    auto& vertexTransforms = object.getVertexTransforms();
-    for (auto& vertexTransform : vertexTransforms) {
-        glm::vec3 pos = vertexTransform.getPosition();
-        if (pos.y < m_groundLevel) {
-            pos.y = m_groundLevel;
-            vertexTransform.setPosition(pos);
-
-            glm::vec3 vel = vertexTransform.getVelocity();
-            if (vel.y < 0.0f) vel.y = 0.0f;
-            vertexTransform.setVelocity(vel);
-        }
+void Scene::endSubstep(
+    XPBDState& state,
+    float deltaTime_s
+)
+{
+    auto& vertexTransforms = state.object->getVertexTransforms();
+    for (size_t i = 0; i < vertexTransforms.size(); ++i) {
+        Transform& vt = vertexTransforms[i];
+        glm::vec3 newV = (state.x[i] - state.p[i]) / deltaTime_s;
+        vt.setPosition(state.x[i]);
+        vt.setVelocity(newV);
     }
 }
 
-void Scene::applyInvisibleBarrierCollision(Object& object) {
-    auto& vertexTransforms = object.getVertexTransforms();
-    for (auto& vertexTransform : vertexTransforms) {
-        glm::vec3 pos = vertexTransform.getPosition();
-        glm::vec3 vel = vertexTransform.getVelocity();
-        if (pos.x < -m_barrierSize) {
-            pos.x = -m_barrierSize;
-            if (vel.x < 0.0f) vel.x = 0.0f;
-        } else if (pos.x > m_barrierSize) {
-            pos.x = m_barrierSize;
-            if (vel.x > 0.0f) vel.x = 0.0f;
-        }
+void Scene::applyXPBD(float deltaTime)
+{
+    // One state per dynamic object; buffers keep their capacity from frame to frame
+    size_t numDynamic = 0;
+    for (const auto& obj : m_objects) {
+        if (obj->isStatic()) continue;
 
-        if (pos.z < -m_barrierSize) {
-            pos.z = -m_barrierSize;
-            if (vel.z < 0.0f) vel.z = 0.0f;
-        } else if (pos.z > m_barrierSize) {
-            pos.z = m_barrierSize;
-            if (vel.z > 0.0f) vel.z = 0.0f;
+        if (m_xpbdStates.size() <= numDynamic) {
+            m_xpbdStates.emplace_back();
         }
+        XPBDState& state = m_xpbdStates[numDynamic++];
+        const size_t numVerts = obj->getVertexTransforms().size();
+        state.object = obj.get();
+        state.M = obj->getMass();
+        state.x.resize(numVerts);
+        state.p.resize(numVerts);
+        state.posDiff.resize(numVerts);
+    }
+    m_xpbdStates.resize(numDynamic);
 
-        vertexTransform.setPosition(pos);
-        vertexTransform.setVelocity(vel);
+    std::vector<CollisionBody> bodies;
+    bodies.reserve(numDynamic);
+    for (auto& state : m_xpbdStates) {
+        bodies.push_back({ state.object, &state.object->getMesh(), &state.p, &state.x, &state.M });
     }
-}
 
-void Scene::updateObjectPhysics(
-    Object& object,
-    float deltaTime,
-    const glm::vec3& cameraPos,
-    const glm::vec3& rayDir
-)
-{
-    if (object.isStatic()) {
-        return;
+    // Contacts are found once per frame along each particle's unconstrained path over the whole
+    // frame, within a margin for how far the substeps stray from it, and only re-projected below
+    m_threadPool->parallel_for(m_xpbdStates, [this, deltaTime](XPBDState& state) {
+        beginSubstep(state, deltaTime);
+        detectObjectContacts(state);
+    });
+    const bool collideObjects = m_enableObjectCollisionConstraints && bodies.size() > 1;
+    if (collideObjects) {
+        m_softBodyCollider.detectContacts(bodies, m_collisionThickness, m_contactMargin, m_threadPool.get());
     }
 
-    applyGravity(object, deltaTime);
-    applyXPBD(object, deltaTime, cameraPos, rayDir);
-    applyGroundCollision(object);
-    applyInvisibleBarrierCollision(object);
-}
+    const int n = m_xpbdSubsteps;
+    float deltaTime_s = deltaTime / static_cast<float>(n);
 
-void Scene::updateObjectTransform(Object& object) {
-    Transform& transform = object.getTransform();
-    transform.setView(*m_camera);
+    // Objects solve their own constraints in parallel, then meet in a shared collision stage each substep
+    for (int subStep = 1; subStep < n + 1; ++subStep) {
+        const float frameFraction = static_cast<float>(subStep) / static_cast<float>(n);
+        m_threadPool->parallel_for(m_xpbdStates, [this, deltaTime_s, frameFraction](XPBDState& state) {
+            beginSubstep(state, deltaTime_s);
+            solveObjectConstraints(state, deltaTime_s, frameFraction);
+        });
+
+        if (collideObjects) {
+            solveObjectCollisionConstraints(bodies, m_softBodyCollider);
+        }
+
+        m_threadPool->parallel_for(m_xpbdStates, [this, deltaTime_s](XPBDState& state) {
+            endSubstep(state, deltaTime_s);
+        });
+    }
 }
 
 void Scene::updateObjects(
@@ -832,10 +1140,28 @@ void Scene::updateObjects(
     const glm::vec3& rayDir
 )
 {
-    m_threadPool->parallel_for(m_objects, [this, deltaTime, cameraPos, rayDir](std::unique_ptr<Object>& obj) {
-        updateObjectTransform(*obj);
-        updateObjectPhysics(*obj, deltaTime, cameraPos, rayDir);
-        obj->update(deltaTime);
+    m_threadPool->parallel_for(m_objects, [this, deltaTime](std::unique_ptr<Object>& obj) {
+        if (!obj->isStatic()) {
+            applyGravity(*obj, deltaTime);
+        } else if (obj->isKinematic()) {
+            obj->advanceKinematic(deltaTime);
+        }
+    });
+
+    // Kinematic objects have moved to where they end the frame; their trees follow, not rebuilt
+    m_envCollider.refitKinematic();
+
+    if (m_activeMouseConstraint.isActive) {
+        updateMouseConstraints(cameraPos, rayDir);
+    }
+
+    // Substeps run across all objects at once, so dynamic objects can collide with each other
+    applyXPBD(deltaTime);
+
+    // Objects the camera can't see skip their render mesh refresh and draw
+    Frustum frustum(m_camera->getProjectionMatrix() * m_camera->getViewMatrix());
+    m_threadPool->parallel_for(m_objects, [this, deltaTime, &frustum](std::unique_ptr<Object>& obj) {
+        obj->update(deltaTime, frustum, m_threadPool.get());
     });
 
     // std::vector<std::future<void>> futures;
@@ -845,7 +1171,6 @@ void Scene::updateObjects(
     //     futures.push_back(
     //         std::async(std::launch::async, [this, i, deltaTime, cameraPos, rayDir]() -> void {
     //             auto& object = m_objects[i];
-    //             updateObjectTransform(*object);
     //             updateObjectPhysics(*object, deltaTime, cameraPos, rayDir);
     //             object->update(deltaTime);
     //         })
@@ -869,19 +1194,89 @@ void Scene::update(float deltaTime) {
 }
 
 void Scene::render() {
-    glEnable(GL_DEPTH_TEST);
+    // ImGui changes state between frames, so the cache starts over
+    m_renderState.beginFrame();
 
-    glEnable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
     glCullFace(GL_BACK);
     glFrontFace(GL_CCW);
 
     glClearColor(0.820, 0.976, 0.973, 1.0f); // TODO : use skybox instead
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    m_renderState.countCalls(5);
+
+    // Camera and light go to every program through one buffer, not per object
+    m_frameUniforms.update(*m_camera, *m_light, m_renderState);
+
+    // Drawn grouped by program, texture, polygon mode and culling rather than in scene order
+    m_renderQueue.clear();
+    for (const auto& object : m_objects) {
+        object->submit(m_renderQueue);
+    }
+    m_renderQueue.execute(m_renderState, m_barrierSize);
+
+    if (m_debugShader) {
+        addDebugGeometry();
+        m_debugDraw.flush(m_renderState, *m_debugShader);
+    }
+
+    m_renderState.bindVertexArray(0);
+    m_renderState.setCullFace(false);
+}
 
+void Scene::addDebugGeometry() {
     for (const auto& object : m_objects) {
-        object->render(m_light.get(), m_camera->getPosition(), m_barrierSize);
+        object->addDebugGeometry(m_debugDraw, m_debugDrawOptions);
+    }
+
+    if (m_debugDrawOptions.bvh) {
+        auto addTree = [this](const Bvh& bvh) {
+            bvh.forEachNode([this](const Aabb& bounds, bool isLeaf) {
+                m_debugDraw.addBox(bounds, isLeaf ? ENV_BVH_LEAF_COLOR : ENV_BVH_NODE_COLOR);
+            });
+        };
+        addTree(m_envCollider.getTriangleBvh());
+        addTree(m_envCollider.getKinematicTriangleBvh());
+    }
+
+    // Where last frame's static contacts hold particles and edges, and the way they push
+    if (m_debugDrawOptions.contacts) {
+        for (const XPBDState& state : m_xpbdStates) {
+            const auto& vertexTransforms = state.object->getVertexTransforms();
+            for (const EnvContact& contact : state.envContacts) {
+                glm::vec3 position = vertexTransforms[contact.vertex].getPosition();
+                m_debugDraw.addPoint(position, CONTACT_COLOR);
+                m_debugDraw.addLine(position, position + contact.normal * CONTACT_NORMAL_LENGTH, CONTACT_COLOR);
+            }
+            for (const EnvEdgeContact& contact : state.envEdgeContacts) {
+                glm::vec3 position = glm::mix(
+                    vertexTransforms[contact.edge.v1].getPosition(),
+                    vertexTransforms[contact.edge.v2].getPosition(),
+                    contact.s
+                );
+                m_debugDraw.addPoint(position, EDGE_CONTACT_COLOR);
+                m_debugDraw.addLine(position, position + contact.normal * CONTACT_NORMAL_LENGTH, EDGE_CONTACT_COLOR);
+            }
+        }
     }
+}
 
+void Scene::resetObjects() {
+    for (auto& obj : m_objects) {
+        obj->resetVertexTransforms();
+        if (SelfCollider* selfCollider = obj->getSelfCollider()) {
+            selfCollider->clearContactCache();
+        }
+    }
+
+    // Kinematic objects jumped back to their first pose, which is not motion contacts should carry
+    m_envCollider.resetKinematic();
+
+    for (auto& state : m_xpbdStates) {
+        state.envCache.clear();
+        state.envEdgeCache.clear();
+    }
+    m_softBodyCollider.clearContactCaches();
 }
 
 void Scene::clear() {
@@ -890,6 +1285,9 @@ void Scene::clear() {
     m_meshManager->deleteAllResources();
     m_shaderManager->deleteAllResources();
     m_objects.clear();
+    m_renderQueue.destroy();
+    m_debugDraw.destroy();
+    m_frameUniforms.destroy();
 
     logger::info(" - Cleared '{}' scene successfully", m_name);
 }
\ No newline at end of file
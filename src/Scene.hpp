@@ -15,6 +15,18 @@
 #include "Camera.hpp"
 #include "Light.hpp"
 #include "Object.hpp"
+#include "MeshGenerator.hpp"
+#include "ColliderSet.hpp"
+#include "ContactCache.hpp"
+#include "DebugDraw.hpp"
+#include "EnvironmentCollider.hpp"
+#include "FrameUniforms.hpp"
+#include "KinematicAnimation.hpp"
+#include "RayCaster.hpp"
+#include "RenderQueue.hpp"
+#include "RenderState.hpp"
+#include "SignedDistanceField.hpp"
+#include "SoftBodyCollider.hpp"
 #include "ThreadPool.hpp"
 
 struct ObjectConfig
@@ -26,14 +38,20 @@ struct ObjectConfig
     glm::vec3 scale;
     std::string shaderName;
     std::string meshName;
+    std::optional<MeshGenerator::Config> meshGenerator;
     std::string textureName;
     glm::vec3 color;
     bool isStatic;
+    bool selfCollision = false;
+    bool hardEdges = false;
+    std::string collider = "mesh";
+    std::optional<KinematicAnimation> animation;
 };
 
 struct SceneConfig {
     std::string name;
     std::vector<ObjectConfig> objects;
+    std::optional<ColliderSet> colliders;
 };
 
 class Scene
@@ -62,17 +80,29 @@ public:
     void update(float deltaTime);
     void render();
     void clear();
+    // Sends every object back to its initial state, dropping contacts remembered from before
+    void resetObjects();
 
     const std::string& getName() { return m_name; }
     Camera* getCamera() { return m_camera.get(); }
     Light* getLight() { return m_light.get(); }
     const std::vector<std::unique_ptr<Object>>& getObjects() const { return m_objects; }
+    // GL calls, skipped state changes and draws of the last rendered frame
+    const RenderState::Stats& getRenderStats() const { return m_renderState.getStats(); }
 
     PickResult pickObject(
         const glm::vec3& rayOrigin,
         const glm::vec3& rayDir
     );
     void createMouseConstraints(const PickResult& pick);
+
+    // Closest hit of every ray against the surfaces of all objects where they are now, traced in
+    // packets across the thread pool; hits must hold one entry per ray
+    void castRays(
+        std::span<const Ray> rays,
+        std::span<RayHit> hits
+    );
+
     void updateMouseConstraints(
         const glm::vec3& cameraPos,
         const glm::vec3& rayDir
@@ -126,15 +156,35 @@ public:
     bool& enableEnvCollisionConstraints() { return m_enableEnvCollisionConstraints; }
     void solveEnvCollisionConstraints(
         std::vector<glm::vec3>& x,
-        const std::vector<glm::vec3>& posDiff,
         const std::vector<float>& M,
-        float alphaTilde,
-        float gamma,
-        std::vector<Mesh::EnvCollisionConstraints> perEnvCollisionConstraints
+        const std::vector<EnvContact>& contacts,
+        const std::vector<EnvEdgeContact>& edgeContacts,
+        float frameFraction
+    );
+
+    void solveSdfCollisionConstraints(
+        std::vector<glm::vec3>& x,
+        const std::vector<glm::vec3>& p,
+        std::span<const unsigned int> vertices
+    );
+
+    bool& enableSelfCollisionConstraints() { return m_enableSelfCollisionConstraints; }
+    void solveSelfCollisionConstraints(
+        std::vector<glm::vec3>& x,
+        const std::vector<float>& M,
+        const SelfCollider& selfCollider
+    );
+
+    bool& enableObjectCollisionConstraints() { return m_enableObjectCollisionConstraints; }
+    void solveObjectCollisionConstraints(
+        const std::vector<CollisionBody>& bodies,
+        const SoftBodyCollider& softBodyCollider
     );
 
     glm::vec3& getGravitationalAcceleration() { return m_gravitationalAcceleration; }
     int& getXPBDSubsteps() { return m_xpbdSubsteps; }
+    float& getContactMargin() { return m_contactMargin; }
+    DebugDraw::Options& getDebugDrawOptions() { return m_debugDrawOptions; }
     float& getAlpha() { return m_alpha; }
     float& getBeta()  { return m_beta;  }
     float& getOverpressureFactor() { return m_k; }
@@ -153,11 +203,17 @@ private:
 
     std::unique_ptr<Camera> m_camera;
     std::unique_ptr<Light> m_light;
+    FrameUniforms m_frameUniforms;
+    RenderQueue m_renderQueue;
+    RenderState m_renderState;
+    DebugDraw m_debugDraw;
+    DebugDraw::Options m_debugDrawOptions;
+    Shader* m_debugShader = nullptr;
 
     std::vector<std::unique_ptr<Object>> m_objects;
 
     glm::vec3 m_gravitationalAcceleration;
-    float m_groundLevel;
+    ColliderSet m_colliders;
 
     int m_xpbdSubsteps;
 
@@ -169,10 +225,32 @@ private:
         std::array<float, 3> initialDistances;
     };
     ActiveMouseConstraint m_activeMouseConstraint;
+    RayCaster m_rayCaster;
 
     bool m_enableDistanceConstraints;
     bool m_enableVolumeConstraints;
     bool m_enableEnvCollisionConstraints;
+    EnvironmentCollider m_envCollider;
+    std::vector<SignedDistanceField> m_sdfColliders;
+    float m_collisionThickness;
+    float m_contactMargin;
+    bool m_enableSelfCollisionConstraints;
+    bool m_enableObjectCollisionConstraints;
+    SoftBodyCollider m_softBodyCollider;
+
+    // Per-substep solver buffers of one dynamic object, and the contacts found for it this frame
+    struct XPBDState {
+        Object* object = nullptr;
+        std::vector<float> M;
+        std::vector<glm::vec3> x;
+        std::vector<glm::vec3> p;
+        std::vector<glm::vec3> posDiff;
+        std::vector<EnvContact> envContacts;
+        std::vector<EnvEdgeContact> envEdgeContacts;
+        ContactCache envCache;
+        ContactCache envEdgeCache;
+    };
+    std::vector<XPBDState> m_xpbdStates;
 
     float m_alpha;
     float m_beta;
@@ -184,19 +262,17 @@ private:
     std::unique_ptr<Camera> createCamera();
     std::unique_ptr<Light> createLight();
 
+    std::optional<std::reference_wrapper<Mesh>> getGeneratedMesh(const MeshGenerator::Config& config);
     std::unique_ptr<Object> createObject(const ObjectConfig& config);
     void createObjects(const SceneConfig& config);
 
     SceneConfig parseSceneConfig(const YAML::Node& sceneYaml);
+    ColliderSet parseColliders(const YAML::Node& collidersYaml);
+    KinematicAnimation parseAnimation(const YAML::Node& animationYaml, const ObjectConfig& objConfig);
 
-    std::optional<glm::vec3> rayIntersectsTriangle(
-        const glm::vec3& ray_origin,
-        const glm::vec3& ray_vector,
-        const Mesh::Triangle& triangle,
-        const std::vector<Transform>& vertexTransforms
-    );
-
-    void setupEnvCollisionConstraints();
+    void setupEnvCollisionConstraints(const std::vector<Object*>& sdfObjects);
+    // Normals and the overlays enabled in the debug options, for this frame's debug draw
+    void addDebugGeometry();
     void applyGravity(
         Object& object,
         float deltaTime
@@ -222,23 +298,24 @@ private:
         std::vector<glm::vec3>& x,
         const std::vector<glm::vec3>& deltaX
     );
-    void applyXPBD(
-        Object& object,
-        float deltaTime,
-        const glm::vec3& cameraPos,
-        const glm::vec3& rayDir
+    void beginSubstep(
+        XPBDState& state,
+        float deltaTime_s
     );
+    void detectObjectContacts(XPBDState& state);
+    void solveObjectConstraints(
+        XPBDState& state,
+        float deltaTime_s,
+        float frameFraction
+    );
+    void endSubstep(
+        XPBDState& state,
+        float deltaTime_s
+    );
+    void applyXPBD(float deltaTime);
 
-    void applyGroundCollision(Object& object);
-    void applyInvisibleBarrierCollision(Object& object);
+    void setupDefaultColliders();
 
-    void updateObjectTransform(Object& object);
-    void updateObjectPhysics(
-        Object& object,
-        float deltaTime,
-        const glm::vec3& cameraPos,
-        const glm::vec3& rayDir
-    );
     void updateObjects(
         float deltaTime,
         const glm::vec3& cameraPos,
@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include "Intersection.hpp"
+#include "MeshAdjacency.hpp"
+#include "SelfCollider.hpp"
+
+namespace
+{
+    // Several chunks per thread, so uneven contact density still balances
+    constexpr size_t CHUNKS_PER_THREAD = 4;
+}
+
+SelfCollider::SelfCollider(const Mesh& mesh, float thickness)
+    : m_adjacency(&mesh.getAdjacency()),
+      m_thickness(thickness),
+      m_spatialHash(2.0f * thickness)
+{
+}
+
+void SelfCollider::splitIntoChunks(std::vector<Chunk>& chunks, size_t count, ThreadPool* threadPool)
+{
+    size_t numChunks = threadPool ? threadPool->getThreadCount() * CHUNKS_PER_THREAD : 1;
+    numChunks = std::max<size_t>(1, std::min(numChunks, count));
+    size_t chunkSize = (count + numChunks - 1) / numChunks;
+
+    chunks.resize(numChunks);
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+        chunks[c].begin = std::min(count, c * chunkSize);
+        chunks[c].end = std::min(count, (c + 1) * chunkSize);
+        chunks[c].pointContacts.clear();
+        chunks[c].triangleContacts.clear();
+    }
+}
+
+bool SelfCollider::areNeighbours(unsigned int a, unsigned int b) const
+{
+    return a == b || m_adjacency->findEdge(a, b) != MeshAdjacency::NO_EDGE;
+}
+
+void SelfCollider::detectPointContacts(const std::vector<glm::vec3>& x, float reach, Chunk& chunk) const
+{
+    float reachSquared = reach * reach;
+    for (size_t i = chunk.begin; i < chunk.end; ++i)
+    {
+        Aabb box;
+        box.expand(x[i]);
+        box.inflate(reach);
+
+        m_spatialHash.query(box, [&](unsigned int j) {
+            if (j <= i) return;
+
+            glm::vec3 d = x[i] - x[j];
+            if (glm::dot(d, d) >= reachSquared || areNeighbours(static_cast<unsigned int>(i), j)) return;
+
+            chunk.pointContacts.push_back({ static_cast<unsigned int>(i), j });
+        });
+    }
+}
+
+void SelfCollider::detectTriangleContacts(
+    const std::vector<glm::vec3>& p,
+    const std::vector<glm::vec3>& x,
+    float reach,
+    Chunk& chunk
+) const
+{
+    const auto& triangles = m_adjacency->getTriangles();
+    for (size_t t = chunk.begin; t < chunk.end; ++t)
+    {
+        const Mesh::Triangle& tri = triangles[t];
+        const glm::vec3 &a = x[tri.v1], &b = x[tri.v2], &c = x[tri.v3];
+
+        glm::vec3 n = glm::cross(b - a, c - a);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n /= length;
+
+        // The side each particle is kept on comes from where it and the triangle started
+        glm::vec3 previousNormal = glm::cross(p[tri.v2] - p[tri.v1], p[tri.v3] - p[tri.v1]);
+
+        Aabb box;
+        box.expand(a);
+        box.expand(b);
+        box.expand(c);
+        box.inflate(reach);
+
+        m_spatialHash.query(box, [&](unsigned int j) {
+            if (areNeighbours(j, tri.v1) || areNeighbours(j, tri.v2) || areNeighbours(j, tri.v3)) return;
+
+            ContactKey key{ j, static_cast<unsigned int>(t) };
+            std::optional<float> cached = m_cache.find(key);
+            float side = cached ? *cached : (glm::dot(previousNormal, p[j] - p[tri.v1]) < 0.0f ? -1.0f : 1.0f);
+            float distance = side * glm::dot(n, x[j] - a);
+            if (distance >= reach) return;
+
+            auto weights = Intersection::barycentric(a, b, c, x[j]);
+            if (!weights || !Intersection::isInside(*weights)) return;
+
+            chunk.triangleContacts.push_back({ j, tri, *weights, side, key });
+        });
+    }
+}
+
+void SelfCollider::detectContacts(
+    const std::vector<glm::vec3>& p,
+    const std::vector<glm::vec3>& x,
+    float margin,
+    ThreadPool* threadPool
+)
+{
+    m_spatialHash.build(x, threadPool);
+
+    splitIntoChunks(m_pointChunks, x.size(), threadPool);
+    splitIntoChunks(m_triangleChunks, m_adjacency->getTriangles().size(), threadPool);
+
+    const float reach = m_thickness + margin;
+    auto detectPoints = [this, &x, reach](Chunk& chunk) { detectPointContacts(x, reach, chunk); };
+    auto detectTriangles = [this, &p, &x, reach](Chunk& chunk) { detectTriangleContacts(p, x, reach, chunk); };
+    if (threadPool)
+    {
+        threadPool->parallel_for(m_pointChunks, detectPoints);
+        threadPool->parallel_for(m_triangleChunks, detectTriangles);
+    }
+    else
+    {
+        for (auto& chunk : m_pointChunks) detectPoints(chunk);
+        for (auto& chunk : m_triangleChunks) detectTriangles(chunk);
+    }
+
+    // Concatenated in chunk order, so the solve order does not depend on scheduling
+    m_pointContacts.clear();
+    for (const auto& chunk : m_pointChunks)
+    {
+        m_pointContacts.insert(m_pointContacts.end(), chunk.pointContacts.begin(), chunk.pointContacts.end());
+    }
+    m_triangleContacts.clear();
+    for (const auto& chunk : m_triangleChunks)
+    {
+        m_triangleContacts.insert(m_triangleContacts.end(), chunk.triangleContacts.begin(), chunk.triangleContacts.end());
+    }
+
+    for (const auto& contact : m_triangleContacts)
+    {
+        m_cache.record(contact.key, contact.side);
+    }
+    m_cache.commit();
+}
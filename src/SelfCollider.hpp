@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ContactCache.hpp"
+#include "Mesh.hpp"
+#include "SpatialHash.hpp"
+#include "ThreadPool.hpp"
+
+class MeshAdjacency;
+
+// Particle-particle and particle-triangle proximity within one mesh, found through a spatial
+// hash rebuilt on every detection. Pairs that share an edge are never in contact.
+class SelfCollider
+{
+public:
+    // Keeps the particle on the side of the triangle it started on, or was kept on last frame
+    struct TriangleContact
+    {
+        unsigned int vertex;
+        Mesh::Triangle triangle;
+        glm::vec3 weights; // barycentric coordinates of the particle over the triangle
+        float side;
+        ContactKey key;    // vertex and triangle index
+    };
+
+    struct PointContact
+    {
+        unsigned int v1;
+        unsigned int v2;
+    };
+
+    SelfCollider() = default;
+    SelfCollider(const Mesh& mesh, float thickness);
+
+    float getThickness() const { return m_thickness; }
+    const std::vector<PointContact>& getPointContacts()       const { return m_pointContacts; }
+    const std::vector<TriangleContact>& getTriangleContacts() const { return m_triangleContacts; }
+
+    // Pairs closer than thickness + margin at x; the contacts themselves hold them at thickness
+    void detectContacts(
+        const std::vector<glm::vec3>& p,
+        const std::vector<glm::vec3>& x,
+        float margin,
+        ThreadPool* threadPool
+    );
+
+    // Forgets the sides of last frame's contacts, e.g. after the particles were reset
+    void clearContactCache() { m_cache.clear(); }
+
+private:
+    struct Chunk
+    {
+        size_t begin;
+        size_t end;
+        std::vector<PointContact> pointContacts;
+        std::vector<TriangleContact> triangleContacts;
+    };
+
+    static void splitIntoChunks(std::vector<Chunk>& chunks, size_t count, ThreadPool* threadPool);
+    bool areNeighbours(unsigned int a, unsigned int b) const;
+    void detectPointContacts(const std::vector<glm::vec3>& x, float reach, Chunk& chunk) const;
+    void detectTriangleContacts(
+        const std::vector<glm::vec3>& p,
+        const std::vector<glm::vec3>& x,
+        float reach,
+        Chunk& chunk
+    ) const;
+
+private:
+    const MeshAdjacency* m_adjacency = nullptr;
+    float m_thickness = 0.0f;
+    SpatialHash m_spatialHash;
+
+    std::vector<Chunk> m_pointChunks;
+    std::vector<Chunk> m_triangleChunks;
+    std::vector<PointContact> m_pointContacts;
+    std::vector<TriangleContact> m_triangleContacts;
+    ContactCache m_cache;
+};
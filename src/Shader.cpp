@@ -99,6 +99,37 @@ void compileShaders(
     glDeleteShader(fragment);
 }
 
+// Every active uniform of the linked program by name; arrays are also listed without their "[0]"
+static std::unordered_map<std::string, GLint> readUniformLocations(
+    unsigned int ID
+)
+{
+    std::unordered_map<std::string, GLint> locations;
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::string name(static_cast<size_t>(maxLength), '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data());
+
+        std::string uniformName(name.data(), static_cast<size_t>(length));
+        GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location < 0) continue; // members of uniform blocks
+
+        locations[uniformName] = location;
+        if (uniformName.size() > 3 && uniformName.ends_with("[0]")) {
+            locations[uniformName.substr(0, uniformName.size() - 3)] = location;
+        }
+    }
+
+    return locations;
+}
+
 Shader::Shader(
     const std::string& name,
     const std::string& vertexPath,
@@ -112,6 +143,13 @@ Shader::Shader(
     std::string fShaderCode;
     getVertexAndFragmentSourceCode(vertexPath, fragmentPath, vShaderCode, fShaderCode);
     compileShaders(m_ID, vShaderCode, fShaderCode);
+
+    m_uniformLocations = std::make_shared<const std::unordered_map<std::string, GLint>>(readUniformLocations(m_ID));
+
+    GLuint frameBlock = glGetUniformBlockIndex(m_ID, FRAME_BLOCK_NAME);
+    if (frameBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(m_ID, frameBlock, FRAME_BLOCK_BINDING);
+    }
 }
 
 void Shader::useProgram() {
@@ -122,13 +160,22 @@ void Shader::destroy() {
     glDeleteProgram(m_ID);
 }
 
+GLint Shader::getUniformLocation(
+    const std::string& name
+) const
+{
+    if (!m_uniformLocations) return -1;
+
+    auto it = m_uniformLocations->find(name);
+    return it != m_uniformLocations->end() ? it->second : -1;
+}
+
 void Shader::setVec3(
     const std::string& name,
     const glm::vec3& value
 ) const
 {
-    int location = glGetUniformLocation(m_ID, name.c_str());
-    glUniform3fv(location, 1, &value[0]);
+    glUniform3fv(getUniformLocation(name), 1, &value[0]);
 }
 
 void Shader::setInt(
@@ -136,7 +183,7 @@ void Shader::setInt(
     int value
 ) const
 {
-    glUniform1i(glGetUniformLocation(m_ID, name.c_str()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 
 void Shader::setFloat(
@@ -144,5 +191,5 @@ void Shader::setFloat(
     float value
 ) const
 {
-    glUniform1f(glGetUniformLocation(m_ID, name.c_str()), value);
+    glUniform1f(getUniformLocation(name), value);
 }
@@ -1,11 +1,18 @@
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <glad.h>
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
 
 class Shader {
+public:
+    // Per-frame camera and light data shared by every program, see FrameUniforms
+    static constexpr const char* FRAME_BLOCK_NAME = "Frame";
+    static constexpr GLuint FRAME_BLOCK_BINDING = 0;
+
 public:
     Shader() = default;
     Shader(const std::string& name, const std::string& vertexPath, const std::string& fragmentPath);
@@ -18,6 +25,9 @@ public:
     void useProgram();
     void destroy();
 
+    // Location from the table read at link time, or -1 for uniforms the program doesn't use
+    GLint getUniformLocation(const std::string& name) const;
+
     void setVec3(const std::string& name, const glm::vec3& value) const;
     void setInt(const std::string &name, int value) const;
     void setFloat(const std::string& name, float value) const;
@@ -28,4 +38,6 @@ private:
     std::string m_fragmentPath;
 
     unsigned int m_ID;
+    // Copies of a shader share its program, so they share its table too
+    std::shared_ptr<const std::unordered_map<std::string, GLint>> m_uniformLocations;
 };
\ No newline at end of file
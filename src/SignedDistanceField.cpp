@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Bvh.hpp"
+#include "logger.hpp"
+#include "MeshAdjacency.hpp"
+#include "SignedDistanceField.hpp"
+
+namespace
+{
+    constexpr uint32_t CACHE_VERSION = 1;
+
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceHash;
+        float origin[3];
+        float cellSize;
+        float bandWidth;
+        int32_t resolution[3];
+    };
+
+    enum Feature { VERTEX_A, VERTEX_B, VERTEX_C, EDGE_AB, EDGE_BC, EDGE_CA, FACE };
+
+    // Closest point on triangle (a, b, c) to p, and which feature it lies on (Ericson, Real-Time Collision Detection 5.1.5)
+    glm::vec3 closestPointOnTriangle(
+        const glm::vec3& p,
+        const glm::vec3& a,
+        const glm::vec3& b,
+        const glm::vec3& c,
+        Feature& feature
+    )
+    {
+        glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+        float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) { feature = VERTEX_A; return a; }
+
+        glm::vec3 bp = p - b;
+        float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) { feature = VERTEX_B; return b; }
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        {
+            feature = EDGE_AB;
+            return a + (d1 / (d1 - d3)) * ab;
+        }
+
+        glm::vec3 cp = p - c;
+        float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) { feature = VERTEX_C; return c; }
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        {
+            feature = EDGE_CA;
+            return a + (d2 / (d2 - d6)) * ac;
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        {
+            feature = EDGE_BC;
+            return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+        }
+
+        float denominator = 1.0f / (va + vb + vc);
+        feature = FACE;
+        return a + ab * (vb * denominator) + ac * (vc * denominator);
+    }
+
+    float cornerAngle(const glm::vec3& corner, const glm::vec3& u, const glm::vec3& v)
+    {
+        glm::vec3 e1 = u - corner, e2 = v - corner;
+        float l1 = glm::length(e1), l2 = glm::length(e2);
+        if (l1 <= 0.0f || l2 <= 0.0f) return 0.0f;
+        return std::acos(glm::clamp(glm::dot(e1, e2) / (l1 * l2), -1.0f, 1.0f));
+    }
+}
+
+void SignedDistanceField::bake(
+    const std::vector<glm::vec3>& positions,
+    const MeshAdjacency& adjacency,
+    float cellSize,
+    float bandWidth,
+    ThreadPool* threadPool
+)
+{
+    const auto& triangles = adjacency.getTriangles();
+    m_cellSize = cellSize;
+    m_bandWidth = bandWidth;
+    m_distances.clear();
+    if (triangles.empty()) return;
+
+    Aabb bounds;
+    for (const auto& tri : triangles)
+    {
+        bounds.expand(positions[tri.v1]);
+        bounds.expand(positions[tri.v2]);
+        bounds.expand(positions[tri.v3]);
+    }
+    bounds.inflate(bandWidth + cellSize);
+    m_origin = bounds.min;
+    m_resolution = glm::ivec3(glm::ceil(bounds.extent() / cellSize)) + 1;
+
+    // Angle-weighted pseudo-normals give the sign near vertices and edges, where face normals disagree
+    std::vector<glm::vec3> faceNormals(triangles.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> vertexNormals(positions.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> edgeNormals(adjacency.getEdges().size(), glm::vec3(0.0f));
+    std::vector<std::array<unsigned int, 3>> triangleEdges(triangles.size());
+    std::vector<Aabb> triangleBounds(triangles.size());
+    for (size_t t = 0; t < triangles.size(); ++t)
+    {
+        const auto& tri = triangles[t];
+        const glm::vec3 &a = positions[tri.v1], &b = positions[tri.v2], &c = positions[tri.v3];
+        glm::vec3 n = glm::cross(b - a, c - a);
+        float length = glm::length(n);
+        if (length > 0.0f) faceNormals[t] = n / length;
+
+        vertexNormals[tri.v1] += cornerAngle(a, b, c) * faceNormals[t];
+        vertexNormals[tri.v2] += cornerAngle(b, c, a) * faceNormals[t];
+        vertexNormals[tri.v3] += cornerAngle(c, a, b) * faceNormals[t];
+
+        triangleEdges[t] = { adjacency.findEdge(tri.v1, tri.v2), adjacency.findEdge(tri.v2, tri.v3), adjacency.findEdge(tri.v3, tri.v1) };
+        for (unsigned int e : triangleEdges[t]) edgeNormals[e] += faceNormals[t];
+
+        triangleBounds[t].expand(a);
+        triangleBounds[t].expand(b);
+        triangleBounds[t].expand(c);
+        triangleBounds[t].inflate(bandWidth);
+    }
+    Bvh bvh;
+    bvh.build(triangleBounds);
+
+    const size_t strideY = m_resolution.x;
+    const size_t strideZ = static_cast<size_t>(m_resolution.x) * m_resolution.y;
+    m_distances.assign(strideZ * m_resolution.z, bandWidth);
+    std::vector<unsigned char> inBand(m_distances.size(), 0);
+
+    // Each task owns a slab of z slices and visits the triangles near it, so no node is shared
+    forRange(threadPool, m_resolution.z, [&](size_t kBegin, size_t kEnd) {
+        Aabb slab;
+        slab.min = m_origin + glm::vec3(0.0f, 0.0f, kBegin * cellSize);
+        slab.max = m_origin + glm::vec3(glm::vec2(m_resolution) * cellSize, (kEnd - 1) * cellSize);
+
+        bvh.query(slab, [&](unsigned int t) {
+            const auto& tri = triangles[t];
+            const glm::vec3 &a = positions[tri.v1], &b = positions[tri.v2], &c = positions[tri.v3];
+            glm::ivec3 lo = glm::max(glm::ivec3(glm::ceil((triangleBounds[t].min - m_origin) / cellSize)), glm::ivec3(0));
+            glm::ivec3 hi = glm::min(glm::ivec3(glm::floor((triangleBounds[t].max - m_origin) / cellSize)), m_resolution - 1);
+            lo.z = std::max(lo.z, static_cast<int>(kBegin));
+            hi.z = std::min(hi.z, static_cast<int>(kEnd) - 1);
+
+            for (int k = lo.z; k <= hi.z; ++k)
+            {
+                for (int j = lo.y; j <= hi.y; ++j)
+                {
+                    for (int i = lo.x; i <= hi.x; ++i)
+                    {
+                        glm::vec3 node = m_origin + glm::vec3(i, j, k) * cellSize;
+                        Feature feature;
+                        glm::vec3 closest = closestPointOnTriangle(node, a, b, c, feature);
+                        float distance = glm::distance(node, closest);
+
+                        size_t index = k * strideZ + j * strideY + i;
+                        if (distance >= std::abs(m_distances[index])) continue;
+
+                        glm::vec3 pseudoNormal;
+                        switch (feature)
+                        {
+                            case VERTEX_A: pseudoNormal = vertexNormals[tri.v1]; break;
+                            case VERTEX_B: pseudoNormal = vertexNormals[tri.v2]; break;
+                            case VERTEX_C: pseudoNormal = vertexNormals[tri.v3]; break;
+                            case EDGE_AB:  pseudoNormal = edgeNormals[triangleEdges[t][0]]; break;
+                            case EDGE_BC:  pseudoNormal = edgeNormals[triangleEdges[t][1]]; break;
+                            case EDGE_CA:  pseudoNormal = edgeNormals[triangleEdges[t][2]]; break;
+                            default:       pseudoNormal = faceNormals[t]; break;
+                        }
+                        m_distances[index] = glm::dot(node - closest, pseudoNormal) < 0.0f ? -distance : distance;
+                        inBand[index] = 1;
+                    }
+                }
+            }
+        });
+    });
+
+    // Nodes beyond the band take the sign of the last band node along their row; rows start outside
+    forRange(threadPool, static_cast<size_t>(m_resolution.y) * m_resolution.z, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row)
+        {
+            float* distances = m_distances.data() + row * strideY;
+            const unsigned char* band = inBand.data() + row * strideY;
+            float farValue = bandWidth;
+            for (int i = 0; i < m_resolution.x; ++i)
+            {
+                if (band[i]) farValue = distances[i] < 0.0f ? -bandWidth : bandWidth;
+                else distances[i] = farValue;
+            }
+        }
+    });
+}
+
+uint64_t SignedDistanceField::hashSource(
+    const std::vector<glm::vec3>& positions,
+    const MeshAdjacency& adjacency,
+    float cellSize,
+    float bandWidth
+)
+{
+    // FNV-1a over the raw bytes
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    const auto& triangles = adjacency.getTriangles();
+    mix(positions.data(), positions.size() * sizeof(glm::vec3));
+    mix(triangles.data(), triangles.size() * sizeof(triangles[0]));
+    mix(&cellSize, sizeof(cellSize));
+    mix(&bandWidth, sizeof(bandWidth));
+    return hash;
+}
+
+bool SignedDistanceField::readCache(const std::string& cachePath, uint64_t sourceHash)
+{
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) return false;
+
+    CacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, "XSDF", 4) != 0
+        || header.version != CACHE_VERSION
+        || header.sourceHash != sourceHash
+        || header.resolution[0] <= 0 || header.resolution[1] <= 0 || header.resolution[2] <= 0)
+    {
+        return false;
+    }
+
+    m_origin = glm::vec3(header.origin[0], header.origin[1], header.origin[2]);
+    m_cellSize = header.cellSize;
+    m_bandWidth = header.bandWidth;
+    m_resolution = glm::ivec3(header.resolution[0], header.resolution[1], header.resolution[2]);
+    m_distances.resize(static_cast<size_t>(m_resolution.x) * m_resolution.y * m_resolution.z);
+    if (!file.read(reinterpret_cast<char*>(m_distances.data()), m_distances.size() * sizeof(float)))
+    {
+        m_distances.clear();
+        return false;
+    }
+    return true;
+}
+
+void SignedDistanceField::writeCache(const std::string& cachePath, uint64_t sourceHash) const
+{
+    CacheHeader header = {
+        { 'X', 'S', 'D', 'F' }, CACHE_VERSION, sourceHash,
+        { m_origin.x, m_origin.y, m_origin.z }, m_cellSize, m_bandWidth,
+        { m_resolution.x, m_resolution.y, m_resolution.z }
+    };
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), ec);
+
+    // Written aside and renamed, so a concurrent launch never reads a partial file
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(m_distances.data()), m_distances.size() * sizeof(float));
+        if (!file)
+        {
+            logger::warning("Failed to write distance field cache: {}", cachePath);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, ec);
+}
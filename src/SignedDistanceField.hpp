@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Aabb.hpp"
+#include "ThreadPool.hpp"
+
+class MeshAdjacency;
+
+// Signed distance to a triangle surface on a dense grid, exact within a narrow band around the
+// surface and clamped to +-bandWidth beyond it. Negative inside closed meshes and below open
+// ones, by the angle-weighted pseudo-normal of the closest feature.
+class SignedDistanceField
+{
+public:
+    void bake(
+        const std::vector<glm::vec3>& positions,
+        const MeshAdjacency& adjacency,
+        float cellSize,
+        float bandWidth,
+        ThreadPool* threadPool = nullptr
+    );
+
+    // The cache is only used while it was baked from the same triangles and grid settings
+    static uint64_t hashSource(
+        const std::vector<glm::vec3>& positions,
+        const MeshAdjacency& adjacency,
+        float cellSize,
+        float bandWidth
+    );
+    bool readCache(const std::string& cachePath, uint64_t sourceHash);
+    void writeCache(const std::string& cachePath, uint64_t sourceHash) const;
+
+    bool empty()                   const { return m_distances.empty(); }
+    const glm::ivec3& getResolution() const { return m_resolution; }
+
+    // Trilinear distance at point and its gradient; outside the grid reads as bandWidth with no gradient
+    float sample(const glm::vec3& point, glm::vec3& gradient) const
+    {
+        glm::vec3 g = (point - m_origin) / m_cellSize;
+        glm::vec3 upper = glm::vec3(m_resolution - 1);
+        if (glm::any(glm::lessThan(g, glm::vec3(0.0f))) || glm::any(glm::greaterThanEqual(g, upper)))
+        {
+            gradient = glm::vec3(0.0f);
+            return m_bandWidth;
+        }
+
+        glm::ivec3 i = glm::ivec3(g);
+        glm::vec3 f = g - glm::vec3(i);
+        const size_t strideY = m_resolution.x;
+        const size_t strideZ = static_cast<size_t>(m_resolution.x) * m_resolution.y;
+        const float* c = m_distances.data() + i.z * strideZ + i.y * strideY + i.x;
+
+        float c000 = c[0],                 c100 = c[1];
+        float c010 = c[strideY],           c110 = c[strideY + 1];
+        float c001 = c[strideZ],           c101 = c[strideZ + 1];
+        float c011 = c[strideZ + strideY], c111 = c[strideZ + strideY + 1];
+
+        float c00 = c000 + f.x * (c100 - c000), c10 = c010 + f.x * (c110 - c010);
+        float c01 = c001 + f.x * (c101 - c001), c11 = c011 + f.x * (c111 - c011);
+        float c0 = c00 + f.y * (c10 - c00), c1 = c01 + f.y * (c11 - c01);
+
+        // Derivatives of the trilinear interpolant, so the gradient is exact for what is sampled
+        float dx0 = (c100 - c000) + f.y * ((c110 - c010) - (c100 - c000));
+        float dx1 = (c101 - c001) + f.y * ((c111 - c011) - (c101 - c001));
+        gradient.x = (dx0 + f.z * (dx1 - dx0)) / m_cellSize;
+        gradient.y = ((c10 - c00) + f.z * ((c11 - c01) - (c10 - c00))) / m_cellSize;
+        gradient.z = (c1 - c0) / m_cellSize;
+
+        return c0 + f.z * (c1 - c0);
+    }
+
+private:
+    glm::vec3 m_origin = glm::vec3(0.0f);
+    float m_cellSize = 1.0f;
+    float m_bandWidth = 0.0f;
+    glm::ivec3 m_resolution = glm::ivec3(0);
+    std::vector<float> m_distances; // x fastest, then y, then z
+};
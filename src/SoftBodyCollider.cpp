@@ -0,0 +1,288 @@
+#include <algorithm>
+
+#include "Ccd.hpp"
+#include "Intersection.hpp"
+#include "MeshAdjacency.hpp"
+#include "SoftBodyCollider.hpp"
+
+void SoftBodyCollider::detectContacts(
+    const std::vector<CollisionBody>& bodies,
+    float thickness,
+    float margin,
+    ThreadPool* threadPool
+)
+{
+    const float reach = thickness + margin;
+
+    // Swept bounds of each body's surface between p and x
+    m_bounds.assign(bodies.size(), Aabb{});
+    forRange(threadPool, bodies.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const CollisionBody& body = bodies[i];
+            for (unsigned int v : body.mesh->envCollisionConstraintVertices)
+            {
+                m_bounds[i].expand((*body.p)[v]);
+                m_bounds[i].expand((*body.x)[v]);
+            }
+            if (!m_bounds[i].isEmpty()) m_bounds[i].inflate(reach);
+        }
+    });
+
+    m_broadphase.findPairs(m_bounds, m_pairIndices);
+
+    // Trees only for bodies that take part in a pair
+    std::vector<unsigned int> paired;
+    for (const auto& [a, b] : m_pairIndices)
+    {
+        paired.push_back(a);
+        paired.push_back(b);
+    }
+    std::sort(paired.begin(), paired.end());
+    paired.erase(std::unique(paired.begin(), paired.end()), paired.end());
+
+    m_trees.resize(bodies.size());
+    forRange(threadPool, paired.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            refitTrees(bodies[paired[i]], reach, m_trees[paired[i]]);
+        }
+    });
+
+    // Body indices only mean the same objects while the set of bodies is unchanged
+    if (m_caches.size() != bodies.size())
+    {
+        m_caches.assign(bodies.size(), ContactCache{});
+        m_edgeCaches.assign(bodies.size(), ContactCache{});
+    }
+
+    m_pairs.resize(m_pairIndices.size());
+    for (size_t i = 0; i < m_pairIndices.size(); ++i)
+    {
+        m_pairs[i].a = m_pairIndices[i].first;
+        m_pairs[i].b = m_pairIndices[i].second;
+    }
+
+    forRange(threadPool, m_pairs.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Pair& pair = m_pairs[i];
+            pair.contacts.clear();
+            detectPairContacts(bodies, pair.a, pair.b, thickness, reach, pair.contacts);
+            detectPairContacts(bodies, pair.b, pair.a, thickness, reach, pair.contacts);
+            pair.edgeContacts.clear();
+            detectPairEdgeContacts(bodies, pair.a, pair.b, reach, pair.edgeContacts);
+        }
+    });
+
+    // Concatenated in pair order, so the solve order does not depend on scheduling
+    m_contacts.clear();
+    for (const auto& pair : m_pairs)
+    {
+        m_contacts.insert(m_contacts.end(), pair.contacts.begin(), pair.contacts.end());
+    }
+    m_edgeContacts.clear();
+    for (const auto& pair : m_pairs)
+    {
+        m_edgeContacts.insert(m_edgeContacts.end(), pair.edgeContacts.begin(), pair.edgeContacts.end());
+    }
+
+    for (const auto& contact : m_contacts)
+    {
+        m_caches[contact.body].record(contact.key, contact.side);
+    }
+    for (const auto& contact : m_edgeContacts)
+    {
+        m_edgeCaches[contact.body].record(contact.key, contact.side);
+    }
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        m_caches[i].commit();
+        m_edgeCaches[i].commit();
+    }
+}
+
+void SoftBodyCollider::refitTrees(const CollisionBody& body, float reach, BodyTrees& trees) const
+{
+    const auto& p = *body.p;
+    const auto& x = *body.x;
+    const auto& edges = body.mesh->envCollisionConstraintEdges;
+
+    // Boxes cover each primitive over the whole sweep, so continuous tests can't miss
+    body.object->refitTriangleBvh(p, x, reach);
+
+    std::vector<Aabb> bounds(edges.size());
+    for (size_t e = 0; e < edges.size(); ++e)
+    {
+        bounds[e].expand(p[edges[e].v1]);
+        bounds[e].expand(x[edges[e].v1]);
+        bounds[e].expand(p[edges[e].v2]);
+        bounds[e].expand(x[edges[e].v2]);
+    }
+
+    // Topology never changes, so the tree from the first detection is refitted from then on
+    if (trees.mesh != body.mesh || trees.edges.size() != edges.size()) trees.edges.build(bounds);
+    else trees.edges.refit(bounds);
+
+    trees.mesh = body.mesh;
+}
+
+void SoftBodyCollider::detectPairContacts(
+    const std::vector<CollisionBody>& bodies,
+    unsigned int body,
+    unsigned int otherBody,
+    float thickness,
+    float reach,
+    std::vector<Contact>& contacts
+) const
+{
+    const CollisionBody& self = bodies[body];
+    const CollisionBody& other = bodies[otherBody];
+    const auto& otherP = *other.p;
+    const auto& otherX = *other.x;
+    const auto& otherTriangles = other.mesh->getAdjacency().getTriangles();
+    const bool oneSided = other.mesh->isClosed();
+    const Bvh& otherBvh = other.object->getTriangleBvh();
+
+    // Only particles inside both bodies' bounds can touch the other surface
+    Aabb overlap;
+    overlap.min = glm::max(m_bounds[body].min, m_bounds[otherBody].min);
+    overlap.max = glm::min(m_bounds[body].max, m_bounds[otherBody].max);
+
+    for (unsigned int vertex : self.mesh->envCollisionConstraintVertices)
+    {
+        const glm::vec3& start = (*self.p)[vertex];
+        const glm::vec3& end = (*self.x)[vertex];
+
+        Aabb sweep;
+        sweep.expand(start);
+        sweep.expand(end);
+        sweep.inflate(reach);
+        if (!sweep.overlaps(overlap)) continue;
+
+        float deepest = 0.0f;
+        Contact contact;
+        otherBvh.query(sweep, [&](unsigned int index) {
+            const Mesh::Triangle& tri = otherTriangles[index];
+            const glm::vec3 &a = otherX[tri.v1], &b = otherX[tri.v2], &c = otherX[tri.v3];
+
+            glm::vec3 n = glm::cross(b - a, c - a);
+            float length = glm::length(n);
+            if (length <= 0.0f) return;
+            n /= length;
+
+            // Closed bodies push outward; open ones keep the particle on the side it started on
+            glm::vec3 previousNormal = glm::cross(otherP[tri.v2] - otherP[tri.v1], otherP[tri.v3] - otherP[tri.v1]);
+            float startDistance = glm::dot(previousNormal, start - otherP[tri.v1]);
+            ContactKey key{ vertex, index, otherBody };
+            std::optional<float> cached = m_caches[body].find(key);
+            float side = cached ? *cached : ((!oneSided && startDistance < 0.0f) ? -1.0f : 1.0f);
+            float distance = side * glm::dot(n, end - a);
+            if (distance >= reach) return;
+            if (oneSided && !cached && startDistance < -thickness * glm::length(previousNormal)) return;
+
+            auto weights = Intersection::barycentric(a, b, c, end);
+            if (!weights || !Intersection::isInside(*weights))
+            {
+                // Passed through the plane but ends beside the triangle: find where it crossed
+                if (distance >= 0.0f) return;
+                auto t = Ccd::vertexTriangle(
+                    start, otherP[tri.v1], otherP[tri.v2], otherP[tri.v3],
+                    end, a, b, c
+                );
+                if (!t) return;
+
+                auto lerp = [t](const glm::vec3& from, const glm::vec3& to) { return from + *t * (to - from); };
+                weights = Intersection::barycentric(
+                    lerp(otherP[tri.v1], a), lerp(otherP[tri.v2], b), lerp(otherP[tri.v3], c), lerp(start, end)
+                );
+                if (!weights) return;
+            }
+
+            float depth = reach - distance;
+            if (depth > deepest)
+            {
+                deepest = depth;
+                contact = { body, vertex, otherBody, tri, *weights, side, key };
+            }
+        });
+
+        if (deepest > 0.0f)
+        {
+            contacts.push_back(contact);
+        }
+    }
+}
+
+void SoftBodyCollider::detectPairEdgeContacts(
+    const std::vector<CollisionBody>& bodies,
+    unsigned int body,
+    unsigned int otherBody,
+    float reach,
+    std::vector<EdgeContact>& contacts
+) const
+{
+    const CollisionBody& self = bodies[body];
+    const CollisionBody& other = bodies[otherBody];
+    const auto& p = *self.p;
+    const auto& x = *self.x;
+    const auto& otherP = *other.p;
+    const auto& otherX = *other.x;
+    const auto& otherEdges = other.mesh->envCollisionConstraintEdges;
+    const Bvh& otherBvh = m_trees[otherBody].edges;
+
+    Aabb overlap;
+    overlap.min = glm::max(m_bounds[body].min, m_bounds[otherBody].min);
+    overlap.max = glm::min(m_bounds[body].max, m_bounds[otherBody].max);
+
+    const auto& edges = self.mesh->envCollisionConstraintEdges;
+    for (unsigned int e = 0; e < edges.size(); ++e)
+    {
+        const Mesh::Edge& edge = edges[e];
+        const glm::vec3 &a0 = p[edge.v1], &b0 = p[edge.v2];
+        const glm::vec3 &a1 = x[edge.v1], &b1 = x[edge.v2];
+
+        Aabb sweep;
+        sweep.expand(a0);
+        sweep.expand(b0);
+        sweep.expand(a1);
+        sweep.expand(b1);
+        sweep.inflate(reach);
+        if (!sweep.overlaps(overlap)) continue;
+
+        std::optional<Ccd::EdgeHit> first;
+        unsigned int firstIndex = 0;
+        otherBvh.query(sweep, [&](unsigned int index) {
+            const Mesh::Edge& o = otherEdges[index];
+            auto hit = Ccd::edgeEdge(a0, b0, otherP[o.v1], otherP[o.v2], a1, b1, otherX[o.v1], otherX[o.v2]);
+            if (hit && (!first || hit->t < first->t))
+            {
+                first = hit;
+                firstIndex = index;
+            }
+        });
+        if (!first) continue;
+        const Mesh::Edge& firstEdge = otherEdges[firstIndex];
+
+        // Perpendicular to both edges at impact, facing from the other edge towards where this one started
+        auto lerp = [](const glm::vec3& from, const glm::vec3& to, float t) { return from + t * (to - from); };
+        const float t = first->t;
+        glm::vec3 c0 = otherP[firstEdge.v1], d0 = otherP[firstEdge.v2];
+        glm::vec3 direction = lerp(b0, b1, t) - lerp(a0, a1, t);
+        glm::vec3 otherDirection = lerp(d0, otherX[firstEdge.v2], t) - lerp(c0, otherX[firstEdge.v1], t);
+        glm::vec3 separation = lerp(a0, b0, first->s) - lerp(c0, d0, first->u);
+
+        glm::vec3 n = glm::cross(direction, otherDirection);
+        if (glm::dot(n, n) <= 1e-12f) n = separation;
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n /= length;
+
+        ContactKey key{ e, firstIndex, otherBody };
+        std::optional<float> cached = m_edgeCaches[body].find(key);
+        float side = cached ? *cached : (glm::dot(n, separation) < 0.0f ? -1.0f : 1.0f);
+        n *= side;
+
+        contacts.push_back({ body, edge, otherBody, firstEdge, first->s, first->u, n, key, side });
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Bvh.hpp"
+#include "ContactCache.hpp"
+#include "Mesh.hpp"
+#include "Object.hpp"
+#include "SweepAndPrune.hpp"
+#include "ThreadPool.hpp"
+
+// One dynamic object's substep state, as seen by the collision stage
+struct CollisionBody
+{
+    Object* object;
+    const Mesh* mesh;
+    const std::vector<glm::vec3>* p;
+    std::vector<glm::vec3>* x;
+    const std::vector<float>* M;
+};
+
+// Vertex-triangle and edge-edge contacts between different dynamic objects. Bodies are paired
+// by a sweep-and-prune broadphase on their swept bounds, and only overlapping pairs run the
+// narrowphase against the other body's triangle and edge BVHs. Those trees are built once per
+// body and refitted to the swept primitives on every detection; the triangle tree is the object's
+// own. Each body caches the sides of its contacts, so they persist from one frame to the next.
+class SoftBodyCollider
+{
+public:
+    // Keeps a particle of body on the side of the other body's triangle it started on
+    struct Contact
+    {
+        unsigned int body;
+        unsigned int vertex;
+        unsigned int otherBody;
+        Mesh::Triangle triangle;
+        glm::vec3 weights; // barycentric coordinates of the particle over the triangle
+        float side;
+        ContactKey key;    // vertex, triangle index and other body
+    };
+
+    // Keeps edge of body apart from otherEdge of the other body along normal:
+    // dot(normal, lerp(edge, s) - lerp(otherEdge, u)) >= thickness
+    struct EdgeContact
+    {
+        unsigned int body;
+        Mesh::Edge edge;
+        unsigned int otherBody;
+        Mesh::Edge otherEdge;
+        float s;
+        float u;
+        glm::vec3 normal;
+        ContactKey key;    // edge index, other edge index and other body
+        float side;
+    };
+
+    // Contacts within thickness + margin along the sweeps from p to x; each holds its features at thickness
+    void detectContacts(
+        const std::vector<CollisionBody>& bodies,
+        float thickness,
+        float margin,
+        ThreadPool* threadPool
+    );
+
+    size_t getPairCount()                      const { return m_pairs.size(); }
+    const std::vector<Contact>& getContacts()  const { return m_contacts; }
+    const std::vector<EdgeContact>& getEdgeContacts() const { return m_edgeContacts; }
+
+    void clearContactCaches()
+    {
+        for (auto& cache : m_caches) cache.clear();
+        for (auto& cache : m_edgeCaches) cache.clear();
+    }
+
+private:
+    struct Pair
+    {
+        unsigned int a;
+        unsigned int b;
+        std::vector<Contact> contacts;
+        std::vector<EdgeContact> edgeContacts;
+    };
+
+    struct BodyTrees
+    {
+        const Mesh* mesh = nullptr; // mesh the tree was built for
+        Bvh edges;
+    };
+
+    void refitTrees(const CollisionBody& body, float reach, BodyTrees& trees) const;
+
+    void detectPairContacts(
+        const std::vector<CollisionBody>& bodies,
+        unsigned int body,
+        unsigned int otherBody,
+        float thickness,
+        float reach,
+        std::vector<Contact>& contacts
+    ) const;
+    void detectPairEdgeContacts(
+        const std::vector<CollisionBody>& bodies,
+        unsigned int body,
+        unsigned int otherBody,
+        float reach,
+        std::vector<EdgeContact>& contacts
+    ) const;
+
+private:
+    SweepAndPrune m_broadphase;
+    std::vector<Aabb> m_bounds;
+    std::vector<BodyTrees> m_trees;
+    std::vector<ContactCache> m_caches;
+    std::vector<ContactCache> m_edgeCaches;
+    std::vector<std::pair<unsigned int, unsigned int>> m_pairIndices;
+    std::vector<Pair> m_pairs;
+    std::vector<Contact> m_contacts;
+    std::vector<EdgeContact> m_edgeContacts;
+};
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <atomic>
+
+#include "SpatialHash.hpp"
+
+void SpatialHash::build(const std::vector<glm::vec3>& x, ThreadPool* threadPool)
+{
+    const size_t n = x.size();
+    size_t tableSize = 16;
+    while (tableSize < 2 * n) tableSize <<= 1;
+    m_tableMask = static_cast<unsigned int>(tableSize - 1);
+
+    m_particleCells.resize(n);
+    m_particleBucket.resize(n);
+    m_cellEntries.resize(n);
+    m_entryCells.resize(n);
+    m_cellStart.assign(tableSize + 1, 0);
+
+    // Count particles per bucket, shifted by one so the scan below yields bucket starts
+    forRange(threadPool, n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_particleCells[i] = cellCoord(x[i]);
+            unsigned int bucket = hashCell(m_particleCells[i]);
+            m_particleBucket[i] = bucket;
+            std::atomic_ref<unsigned int>(m_cellStart[bucket + 1]).fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Blocked prefix sum: per-block totals, a short serial scan over blocks, then per-block scans
+    const size_t numBlocks = threadPool ? std::max<size_t>(1, threadPool->getThreadCount()) : 1;
+    const size_t blockSize = (m_cellStart.size() + numBlocks - 1) / numBlocks;
+    std::vector<unsigned int> blockBase(numBlocks, 0);
+    forRange(threadPool, numBlocks, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b)
+        {
+            size_t end = std::min(m_cellStart.size(), (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < end; ++i) blockBase[b] += m_cellStart[i];
+        }
+    });
+    unsigned int running = 0;
+    for (auto& base : blockBase)
+    {
+        unsigned int total = base;
+        base = running;
+        running += total;
+    }
+    forRange(threadPool, numBlocks, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; ++b)
+        {
+            unsigned int sum = blockBase[b];
+            size_t end = std::min(m_cellStart.size(), (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < end; ++i)
+            {
+                sum += m_cellStart[i];
+                m_cellStart[i] = sum;
+            }
+        }
+    });
+
+    // Scatter into buckets
+    m_cursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+    forRange(threadPool, n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            unsigned int slot = std::atomic_ref<unsigned int>(m_cursor[m_particleBucket[i]]).fetch_add(1, std::memory_order_relaxed);
+            m_cellEntries[slot] = static_cast<unsigned int>(i);
+        }
+    });
+
+    // The scatter order depends on thread timing; sorting buckets keeps query order deterministic
+    forRange(threadPool, tableSize, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            if (m_cellStart[b + 1] - m_cellStart[b] > 1)
+            {
+                std::sort(m_cellEntries.begin() + m_cellStart[b], m_cellEntries.begin() + m_cellStart[b + 1]);
+            }
+            for (unsigned int i = m_cellStart[b]; i < m_cellStart[b + 1]; ++i)
+            {
+                m_entryCells[i] = m_particleCells[m_cellEntries[i]];
+            }
+        }
+    });
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Aabb.hpp"
+#include "ThreadPool.hpp"
+
+// Uniform grid over particles, hashed into a table twice the particle count. Rebuilt from
+// scratch with a parallel counting sort, so the cost stays linear in the particle count.
+class SpatialHash
+{
+public:
+    SpatialHash() = default;
+    explicit SpatialHash(float spacing) : m_spacing(spacing) {}
+
+    float getSpacing() const { return m_spacing; }
+
+    void build(const std::vector<glm::vec3>& x, ThreadPool* threadPool = nullptr);
+
+    // Calls func(particleIndex) for the particles of every cell the box touches
+    template<typename Func>
+    void query(const Aabb& box, Func&& func) const
+    {
+        if (m_cellStart.empty()) return;
+
+        glm::ivec3 lo = cellCoord(box.min), hi = cellCoord(box.max);
+        for (int ix = lo.x; ix <= hi.x; ++ix)
+        {
+            for (int iy = lo.y; iy <= hi.y; ++iy)
+            {
+                for (int iz = lo.z; iz <= hi.z; ++iz)
+                {
+                    glm::ivec3 cell(ix, iy, iz);
+                    unsigned int bucket = hashCell(cell);
+                    for (unsigned int i = m_cellStart[bucket]; i < m_cellStart[bucket + 1]; ++i)
+                    {
+                        // Other cells hashed into the same bucket are skipped, which also prevents duplicates
+                        if (m_entryCells[i] == cell)
+                        {
+                            func(m_cellEntries[i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    glm::ivec3 cellCoord(const glm::vec3& position) const
+    {
+        return glm::ivec3(glm::floor(position / m_spacing));
+    }
+
+    unsigned int hashCell(const glm::ivec3& cell) const
+    {
+        unsigned int h = (static_cast<unsigned int>(cell.x) * 92837111u)
+                       ^ (static_cast<unsigned int>(cell.y) * 689287499u)
+                       ^ (static_cast<unsigned int>(cell.z) * 283923481u);
+        return h & m_tableMask;
+    }
+
+private:
+    float m_spacing = 1.0f;
+    unsigned int m_tableMask = 0;
+
+    std::vector<glm::ivec3> m_particleCells;
+    std::vector<unsigned int> m_particleBucket;
+    std::vector<unsigned int> m_cellStart;   // table size + 1 offsets into m_cellEntries
+    std::vector<unsigned int> m_cellEntries; // particle indices grouped by bucket
+    std::vector<glm::ivec3> m_entryCells;    // cell of each entry, to tell colliding cells apart
+    std::vector<unsigned int> m_cursor;
+};
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <numeric>
+
+#include "SweepAndPrune.hpp"
+
+void SweepAndPrune::findPairs(const std::vector<Aabb>& boxes, std::vector<std::pair<unsigned int, unsigned int>>& pairs)
+{
+    pairs.clear();
+
+    bool reset = m_order.size() != boxes.size();
+    if (reset)
+    {
+        m_order.resize(boxes.size());
+        std::iota(m_order.begin(), m_order.end(), 0u);
+    }
+
+    // Sweep along the axis with the largest variance of box centers
+    glm::vec3 sum(0.0f), sumSquared(0.0f);
+    size_t count = 0;
+    for (const auto& box : boxes)
+    {
+        if (box.isEmpty()) continue;
+        glm::vec3 c = box.center();
+        sum += c;
+        sumSquared += c * c;
+        ++count;
+    }
+    if (count < 2) return;
+
+    glm::vec3 variance = sumSquared / static_cast<float>(count) - (sum * sum) / static_cast<float>(count * count);
+    int axis = variance.x > variance.y ? (variance.x > variance.z ? 0 : 2) : (variance.y > variance.z ? 1 : 2);
+
+    auto lowerBound = [&boxes, axis](unsigned int a, unsigned int b) { return boxes[a].min[axis] < boxes[b].min[axis]; };
+    if (reset || axis != m_axis)
+    {
+        std::sort(m_order.begin(), m_order.end(), lowerBound);
+        m_axis = axis;
+    }
+    else
+    {
+        // Last frame's order is almost sorted, where insertion sort runs in close to linear time
+        for (size_t i = 1; i < m_order.size(); ++i)
+        {
+            unsigned int index = m_order[i];
+            size_t j = i;
+            for (; j > 0 && lowerBound(index, m_order[j - 1]); --j) m_order[j] = m_order[j - 1];
+            m_order[j] = index;
+        }
+    }
+
+    for (size_t i = 0; i < m_order.size(); ++i)
+    {
+        const Aabb& a = boxes[m_order[i]];
+        if (a.isEmpty()) continue;
+
+        for (size_t j = i + 1; j < m_order.size(); ++j)
+        {
+            const Aabb& b = boxes[m_order[j]];
+            if (b.min[axis] > a.max[axis]) break;
+            if (b.isEmpty() || !a.overlaps(b)) continue;
+
+            pairs.push_back(std::minmax(m_order[i], m_order[j]));
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "Aabb.hpp"
+
+// Broadphase over a small set of boxes: sort by the lower bound on the axis where the boxes
+// are most spread out, then sweep. The order persists between calls and is repaired with an
+// insertion sort, so frame-to-frame coherence keeps the sort close to linear.
+class SweepAndPrune
+{
+public:
+    // Overlapping pairs (i < j) of non-empty boxes, in ascending order
+    void findPairs(const std::vector<Aabb>& boxes, std::vector<std::pair<unsigned int, unsigned int>>& pairs);
+
+private:
+    std::vector<unsigned int> m_order;
+    int m_axis = -1;
+};
@@ -1,45 +1,266 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
 #include "logger.hpp"
 #include "Texture.hpp"
 
+namespace
+{
+    constexpr int CHANNELS = 3;
+    constexpr uint32_t CACHE_VERSION = 1;
+
+    // Cached mip chains are only reused while the source file keeps the same size and timestamp
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        int32_t width;
+        int32_t height;
+    };
+
+    bool describeSource(const std::string& texturePath, uint64_t& size, int64_t& time)
+    {
+        std::error_code ec;
+        size = std::filesystem::file_size(texturePath, ec);
+        if (ec) return false;
+        time = std::filesystem::last_write_time(texturePath, ec).time_since_epoch().count();
+        return !ec;
+    }
+}
+
+std::vector<Texture::MipLevel> Texture::layoutMipChain(int width, int height)
+{
+    std::vector<MipLevel> levels;
+    size_t offset = 0;
+    while (true)
+    {
+        levels.push_back({ width, height, offset });
+        offset += static_cast<size_t>(width) * height * CHANNELS;
+        if (width == 1 && height == 1) break;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return levels;
+}
+
+Texture::MipChain Texture::buildMipChain(const unsigned char* pixels, int width, int height)
+{
+    MipChain mipChain;
+    mipChain.levels = layoutMipChain(width, height);
+    const MipLevel& last = mipChain.levels.back();
+    mipChain.data.resize(last.offset + static_cast<size_t>(last.width) * last.height * CHANNELS);
+    std::memcpy(mipChain.data.data(), pixels, static_cast<size_t>(width) * height * CHANNELS);
+
+    // 2x2 box filter, clamping at the edge of odd-sized levels
+    for (size_t l = 1; l < mipChain.levels.size(); ++l)
+    {
+        const MipLevel& src = mipChain.levels[l - 1];
+        const MipLevel& dst = mipChain.levels[l];
+        const unsigned char* in = mipChain.data.data() + src.offset;
+        unsigned char* out = mipChain.data.data() + dst.offset;
+
+        for (int y = 0; y < dst.height; ++y)
+        {
+            int y0 = std::min(2 * y, src.height - 1), y1 = std::min(2 * y + 1, src.height - 1);
+            for (int x = 0; x < dst.width; ++x)
+            {
+                int x0 = std::min(2 * x, src.width - 1), x1 = std::min(2 * x + 1, src.width - 1);
+                for (int c = 0; c < CHANNELS; ++c)
+                {
+                    int sum = in[(y0 * src.width + x0) * CHANNELS + c] + in[(y0 * src.width + x1) * CHANNELS + c]
+                            + in[(y1 * src.width + x0) * CHANNELS + c] + in[(y1 * src.width + x1) * CHANNELS + c];
+                    out[(y * dst.width + x) * CHANNELS + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    return mipChain;
+}
+
+bool Texture::readCache(const std::string& cachePath, const std::string& texturePath, MipChain& mipChain)
+{
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file) return false;
+
+    CacheHeader header;
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, "XTEX", 4) != 0
+        || header.version != CACHE_VERSION
+        || !describeSource(texturePath, sourceSize, sourceTime)
+        || header.sourceSize != sourceSize
+        || header.sourceTime != sourceTime
+        || header.width <= 0 || header.height <= 0)
+    {
+        return false;
+    }
+
+    mipChain.levels = layoutMipChain(header.width, header.height);
+    const MipLevel& last = mipChain.levels.back();
+    mipChain.data.resize(last.offset + static_cast<size_t>(last.width) * last.height * CHANNELS);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(mipChain.data.data()), mipChain.data.size()));
+}
+
+void Texture::writeCache(const std::string& cachePath, const std::string& texturePath, const MipChain& mipChain)
+{
+    CacheHeader header = { { 'X', 'T', 'E', 'X' }, CACHE_VERSION, 0, 0, mipChain.levels[0].width, mipChain.levels[0].height };
+    if (!describeSource(texturePath, header.sourceSize, header.sourceTime)) return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), ec);
+
+    // Written aside and renamed, so a concurrent launch never reads a partial file
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(mipChain.data.data()), mipChain.data.size());
+        if (!file)
+        {
+            logger::warning("Failed to write texture cache: {}", cachePath);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, ec);
+}
+
+void Texture::decode(
+    const std::string& texturePath,
+    const std::string& cachePath,
+    LoadState& state
+)
+{
+    MipChain mipChain;
+    if (!cachePath.empty() && readCache(cachePath, texturePath, mipChain))
+    {
+        logger::debug("Read texture mip chain from cache: {}", cachePath);
+    }
+    else
+    {
+        stbi_set_flip_vertically_on_load_thread(true);
+        int width, height, nrComponents;
+        unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &nrComponents, CHANNELS);
+        if (!data)
+        {
+            logger::error("Failed to load texture: {}", texturePath);
+            state.status.store(Status::Failed, std::memory_order_release);
+            return;
+        }
+
+        mipChain = buildMipChain(data, width, height);
+        stbi_image_free(data);
+
+        if (!cachePath.empty())
+        {
+            writeCache(cachePath, texturePath, mipChain);
+        }
+    }
+
+    state.mipChain = std::move(mipChain);
+    state.status.store(Status::Decoded, std::memory_order_release);
+}
+
 Texture::Texture(
     const std::string& name,
-    const std::string& texturePath
+    const std::string& texturePath,
+    const std::string& cacheDirectory,
+    ThreadPool* threadPool
 )
-    : m_name(name), m_texturePath(texturePath)
+    : m_name(name),
+      m_texturePath(texturePath),
+      m_cachePath(cacheDirectory.empty() ? "" : cacheDirectory + name + ".mips"),
+      m_threadPool(threadPool),
+      m_state(std::make_shared<LoadState>())
 {
-    glGenTextures(1, &m_ID);
+}
 
-    // Load the texture
-    stbi_set_flip_vertically_on_load(true);
-    int width, height, nrComponents;
-    unsigned char* data = stbi_load(texturePath.c_str(), &width, &height, &nrComponents, 3);
-    if (data)
+void Texture::request()
+{
+    if (!m_state || m_state->status.load(std::memory_order_acquire) != Status::Unrequested)
     {
-        glBindTexture(GL_TEXTURE_2D, m_ID);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // Set texture wrapping and filtering options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        return;
+    }
 
-        stbi_image_free(data);
+    m_state->status.store(Status::Decoding, std::memory_order_relaxed);
+    if (m_threadPool)
+    {
+        m_threadPool->enqueue([state = m_state, texturePath = m_texturePath, cachePath = m_cachePath]() {
+            decode(texturePath, cachePath, *state);
+        });
     }
     else
     {
-        logger::error("Failed to load texture: {}", texturePath);
-        stbi_image_free(data);
+        decode(m_texturePath, m_cachePath, *m_state);
     }
 }
 
-void Texture::bind()
+void Texture::upload()
 {
-    glBindTexture(GL_TEXTURE_2D, m_ID);
+    glGenTextures(1, &m_state->ID);
+    glBindTexture(GL_TEXTURE_2D, m_state->ID);
+
+    // Levels are tightly packed RGB rows
+    const MipChain& mipChain = m_state->mipChain;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t l = 0; l < mipChain.levels.size(); ++l)
+    {
+        const MipLevel& level = mipChain.levels[l];
+        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(l), GL_RGB, level.width, level.height, 0, GL_RGB, GL_UNSIGNED_BYTE, mipChain.data.data() + level.offset);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // Set texture wrapping and filtering options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipChain.levels.size() - 1));
+
+    // The GL copy is authoritative now
+    m_state->mipChain = MipChain();
+    m_state->status.store(Status::Resident, std::memory_order_relaxed);
+}
+
+bool Texture::makeResident()
+{
+    if (!m_state)
+    {
+        return false;
+    }
+
+    request();
+    Status status = m_state->status.load(std::memory_order_acquire);
+    if (status == Status::Decoded)
+    {
+        upload();
+        status = Status::Resident;
+    }
+
+    return status == Status::Resident;
 }
 
 void Texture::destroy()
 {
-    glDeleteTextures(1, &m_ID);
-}
\ No newline at end of file
+    if (!m_state)
+    {
+        return;
+    }
+
+    if (m_state->ID != 0)
+    {
+        glDeleteTextures(1, &m_state->ID);
+        m_state->ID = 0;
+    }
+
+    // A destroyed texture reloads on its next bind, from the disk cache when one exists
+    if (m_state->status.load(std::memory_order_acquire) == Status::Resident)
+    {
+        m_state->status.store(Status::Unrequested, std::memory_order_relaxed);
+    }
+}
@@ -1,25 +1,78 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 #include <glad.h>
 #include <stb_image.h>
 
+#include "ThreadPool.hpp"
+
 class Texture
 {
 public:
     Texture() = default;
-    Texture(const std::string& name, const std::string& filePath);
+    Texture(
+        const std::string& name,
+        const std::string& filePath,
+        const std::string& cacheDirectory = "",
+        ThreadPool* threadPool = nullptr
+    );
 
     const std::string getName()        const { return m_name; }
     const std::string getTexturePath() const { return m_texturePath; }
-    const unsigned int getID()         const { return m_ID; }
+    const unsigned int getID()         const { return m_state ? m_state->ID : 0; }
 
-    void bind();
+    // Starts decoding on the pool, a no-op once requested. Textures nobody requests are never read
+    void request();
+    // Uploads a finished decode on first use, which leaves it bound; returns false while the
+    // texture is not resident yet. Binding for draws goes through the render state cache.
+    bool makeResident();
     void destroy();
 
+private:
+    enum class Status { Unrequested, Decoding, Decoded, Resident, Failed };
+
+    struct MipLevel
+    {
+        int width;
+        int height;
+        size_t offset;
+    };
+
+    // Decoded RGB8 image with its full mip chain packed back to back, as stored in the disk cache
+    struct MipChain
+    {
+        std::vector<MipLevel> levels;
+        std::vector<unsigned char> data;
+    };
+
+    // Shared by copies of the texture, written by the decoding worker until status is Decoded
+    struct LoadState
+    {
+        std::atomic<Status> status{Status::Unrequested};
+        MipChain mipChain;
+        unsigned int ID = 0;
+    };
+
+    static void decode(
+        const std::string& texturePath,
+        const std::string& cachePath,
+        LoadState& state
+    );
+    static bool readCache(const std::string& cachePath, const std::string& texturePath, MipChain& mipChain);
+    static void writeCache(const std::string& cachePath, const std::string& texturePath, const MipChain& mipChain);
+    static std::vector<MipLevel> layoutMipChain(int width, int height);
+    static MipChain buildMipChain(const unsigned char* pixels, int width, int height);
+
+    void upload();
+
 private:
     std::string m_name;
     std::string m_texturePath;
+    std::string m_cachePath;
+    ThreadPool* m_threadPool = nullptr;
 
-    unsigned int m_ID;
-};
\ No newline at end of file
+    std::shared_ptr<LoadState> m_state;
+};
@@ -44,5 +44,32 @@ void ThreadPool::workerThread() {
         }
 
         task();
+        notifyTaskFinished();
     }
+}
+
+bool ThreadPool::runPendingTask() {
+    std::function<void()> task;
+
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        if (m_tasks.empty()) {
+            return false;
+        }
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop();
+    }
+
+    task();
+    notifyTaskFinished();
+    return true;
+}
+
+void ThreadPool::notifyTaskFinished() {
+    // Taking the lock orders the notify after a waiter's readiness check, so the wakeup can't be lost
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+    }
+    m_waitCondition.notify_all();
 }
\ No newline at end of file
@@ -13,6 +13,8 @@ public:
     explicit ThreadPool(size_t numThreads = 0);
     ~ThreadPool();
 
+    size_t getThreadCount() const { return m_threads.size(); }
+
     template<typename Container, typename Func>
     void parallel_for(Container& container, Func func) {
         size_t size = container.size();
@@ -33,10 +35,44 @@ public:
         }
 
         for (auto& future : futures) {
-            future.get();
+            wait(future);
         }
     }
 
+    // Calls func(begin, end) on contiguous slices of [0, count), one per thread
+    template<typename Func>
+    void parallel_for_range(size_t count, Func func) {
+        if (count == 0) return;
+
+        size_t numChunks = std::min(count, m_threads.size());
+        size_t chunkSize = (count + numChunks - 1) / numChunks;
+        std::vector<std::future<void>> futures;
+        futures.reserve(numChunks);
+
+        for (size_t begin = 0; begin < count; begin += chunkSize) {
+            size_t end = std::min(begin + chunkSize, count);
+            futures.push_back(enqueue([func, begin, end]() { func(begin, end); }));
+        }
+
+        for (auto& future : futures) {
+            wait(future);
+        }
+    }
+
+    // Runs queued tasks while waiting, so a task may itself call parallel_for without deadlocking the pool.
+    // With nothing queued it sleeps until a task finishes or another is queued.
+    template<typename T>
+    void wait(std::future<T>& future) {
+        auto isReady = [&future]() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+        while (!isReady()) {
+            if (runPendingTask()) continue;
+
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_waitCondition.wait(lock, [this, &isReady]() { return !m_tasks.empty() || isReady(); });
+        }
+        future.get();
+    }
+
     template<typename Func>
     auto enqueue(Func func) -> std::future<decltype(func())> {
         auto task = std::make_shared<std::packaged_task<decltype(func())()>>(func);
@@ -48,6 +84,7 @@ public:
         }
 
         m_condition.notify_one();
+        m_waitCondition.notify_all();
         return result;
     }
 
@@ -56,8 +93,22 @@ private:
     std::queue<std::function<void()>> m_tasks;
     std::mutex m_queueMutex;
     std::condition_variable m_condition;
+    std::condition_variable m_waitCondition; // wakes wait() when a task is queued or finishes
     bool m_stop = false;
 
 private:
     void workerThread();
-};
\ No newline at end of file
+    bool runPendingTask();
+    void notifyTaskFinished();
+};
+
+// Runs func(begin, end) over [0, count) on the pool's workers, or as one slice on the calling thread without a pool
+template<typename Func>
+void forRange(ThreadPool* threadPool, size_t count, Func func) {
+    if (threadPool) {
+        threadPool->parallel_for_range(count, func);
+    }
+    else {
+        func(size_t(0), count);
+    }
+}
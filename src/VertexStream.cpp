@@ -0,0 +1,145 @@
+#include <cstring>
+
+#include "RenderState.hpp"
+#include "VertexStream.hpp"
+
+namespace
+{
+    // Fence waits poll in 1 ms slices; only the first flushes, which is enough for the fence to signal
+    constexpr GLuint64 WAIT_TIMEOUT_NS = 1000000;
+}
+
+void VertexStream::create(size_t segmentSize, const void* data)
+{
+    m_segmentSize = segmentSize;
+    m_segment = 0;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    allocate(segmentSize, data);
+}
+
+void VertexStream::allocate(size_t segmentSize, const void* data)
+{
+    const GLsizeiptr totalSize = static_cast<GLsizeiptr>(segmentSize * SEGMENT_COUNT);
+
+    if (GLAD_GL_VERSION_4_4)
+    {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+        m_mapped = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags));
+        if (m_mapped)
+        {
+            m_mode = Mode::Persistent;
+            if (data) std::memcpy(m_mapped, data, segmentSize);
+            return;
+        }
+
+        // Storage is immutable, so a buffer that wouldn't map is replaced before falling back
+        glDeleteBuffers(1, &m_buffer);
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    }
+
+    if (GLAD_GL_VERSION_3_2)
+    {
+        m_mode = Mode::Unsynchronized;
+        glBufferData(GL_ARRAY_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+        if (data) glBufferSubData(GL_ARRAY_BUFFER, 0, segmentSize, data);
+        return;
+    }
+
+    m_mode = Mode::Orphaning;
+    glBufferData(GL_ARRAY_BUFFER, segmentSize, data, GL_STREAM_DRAW);
+}
+
+void VertexStream::destroy()
+{
+    for (GLsync& fence : m_fences)
+    {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    // Deleting the buffer also unmaps it
+    glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_mapped = nullptr;
+}
+
+unsigned int VertexStream::write(const void* data, size_t size, RenderState& state)
+{
+    state.countUpload();
+    if (m_mode == Mode::Orphaning)
+    {
+        // The driver hands back fresh storage while draws still in flight keep the old one
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        glBufferData(GL_ARRAY_BUFFER, m_segmentSize, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+        state.countCalls(3);
+        return 0;
+    }
+
+    const unsigned int segment = (m_segment + 1) % SEGMENT_COUNT;
+    waitForSegment(segment, state);
+    m_segment = segment;
+
+    const size_t offset = segment * m_segmentSize;
+    if (m_mode == Mode::Persistent)
+    {
+        std::memcpy(m_mapped + offset, data, size);
+        return segment;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    void* destination = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, flags);
+    state.countCalls(2);
+    bool written = false;
+    if (destination)
+    {
+        std::memcpy(destination, data, size);
+        written = glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+        state.countCalls(1);
+    }
+
+    // The mapping failed or its contents were lost; the fence already guarantees the segment is free
+    if (!written)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+        state.countCalls(1);
+    }
+    return segment;
+}
+
+void VertexStream::fence(unsigned int segment, RenderState& state)
+{
+    if (m_mode == Mode::Orphaning) return;
+
+    if (m_fences[segment])
+    {
+        glDeleteSync(m_fences[segment]);
+        state.countCalls(1);
+    }
+    m_fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    state.countCalls(1);
+}
+
+void VertexStream::waitForSegment(unsigned int segment, RenderState& state)
+{
+    GLsync& fence = m_fences[segment];
+    if (!fence) return;
+
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true)
+    {
+        GLenum result = glClientWaitSync(fence, flags, WAIT_TIMEOUT_NS);
+        state.countCalls(1);
+        if (result != GL_TIMEOUT_EXPIRED) break;
+        flags = 0;
+    }
+
+    glDeleteSync(fence);
+    state.countCalls(1);
+    fence = nullptr;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <glad.h>
+
+class RenderState;
+
+// Vertex buffer the CPU rewrites while the GPU may still be drawing its earlier contents. It holds
+// SEGMENT_COUNT copies of the data; each write goes to the next segment once the fence placed when
+// that segment was last drawn has passed, so neither side waits on the other.
+// With GL 4.4 buffer storage the buffer stays mapped and a write is a plain memcpy. On GL 3.3 each
+// segment is mapped unsynchronized for the write, and without fences the buffer is orphaned instead.
+class VertexStream
+{
+public:
+    static constexpr unsigned int SEGMENT_COUNT = 3;
+
+    enum class Mode
+    {
+        Persistent,
+        Unsynchronized,
+        Orphaning
+    };
+
+    // Creates the buffer, bound to GL_ARRAY_BUFFER, with data (if any) in its first segment
+    void create(size_t segmentSize, const void* data);
+    void destroy();
+
+    // Copies data into the next free segment and returns its index. The upload and the GL calls it
+    // takes, waits on the segment's fence included, are counted in state.
+    unsigned int write(const void* data, RenderState& state) { return write(data, m_segmentSize, state); }
+    // Same for the first size bytes of a segment, for streams whose contents vary in length
+    unsigned int write(const void* data, size_t size, RenderState& state);
+
+    // Keeps the segment from being rewritten until the draws issued so far have finished with it
+    void fence(unsigned int segment, RenderState& state);
+
+    GLuint getBuffer() const { return m_buffer; }
+    Mode getMode()     const { return m_mode; }
+
+private:
+    void allocate(size_t segmentSize, const void* data);
+    void waitForSegment(unsigned int segment, RenderState& state);
+
+private:
+    GLuint m_buffer = 0;
+    size_t m_segmentSize = 0;
+    Mode m_mode = Mode::Orphaning;
+    unsigned int m_segment = 0;
+    unsigned char* m_mapped = nullptr;
+    GLsync m_fences[SEGMENT_COUNT] = {};
+};
@@ -1,15 +1,49 @@
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
 #include "logger.hpp"
 #include "PhysicsEngine.hpp"
 
 const unsigned int SCREEN_WIDTH = 1280;
 const unsigned int SCREEN_HEIGHT = 720;
 
+// --headless [--frames N] [--output DIR] [--scene NAME]
+std::optional<HeadlessConfig> parseHeadlessConfig(int argc, char* argv[]) {
+    bool headless = false;
+    HeadlessConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            config.frameCount = static_cast<unsigned int>(std::stoul(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+            config.outputDirectory = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--scene") == 0 && hasValue) {
+            config.sceneName = argv[++i];
+        }
+        else {
+            throw std::invalid_argument("Unknown argument '" + std::string(argv[i]) + "'");
+        }
+    }
+
+    if (!headless) return std::nullopt;
+    return config;
+}
+
 int main(int argc, char* argv[]) {
     try {
         PhysicsEngine physicsEngine(
             "XPBD Softbody Simulation",
             SCREEN_WIDTH,
-            SCREEN_HEIGHT
+            SCREEN_HEIGHT,
+            parseHeadlessConfig(argc, argv)
         );
         while (physicsEngine.isRunning()) {
             physicsEngine.handleEvents();